@@ -3,6 +3,9 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <map>
+#include <string>
+
 #include "base/path_service.h"
 #include "base/run_loop.h"
 #include "base/task/post_task.h"
@@ -22,6 +25,7 @@
 #include "chrome/test/base/ui_test_utils.h"
 #include "content/public/test/browser_test.h"
 #include "content/public/test/browser_test_utils.h"
+#include "extensions/browser/extension_registry.h"
 #include "net/dns/mock_host_resolver.h"
 
 using brave_rewards::RewardsService;
@@ -129,6 +133,20 @@ class GreaselionServiceTest : public BaseLocalDataFilesBrowserTest {
         ->size();
   }
 
+  // Returns the install path of every loaded Greaselion extension. A rule's
+  // extension id doesn't change when it's regenerated, but its path does.
+  std::map<std::string, base::FilePath> GetGreaselionExtensionPaths() {
+    GreaselionService* greaselion_service =
+        GreaselionServiceFactory::GetForBrowserContext(profile());
+    std::map<std::string, base::FilePath> paths;
+    for (const auto& extension :
+         extensions::ExtensionRegistry::Get(profile())->enabled_extensions()) {
+      if (greaselion_service->IsGreaselionExtension(extension->id()))
+        paths[extension->id()] = extension->path();
+    }
+    return paths;
+  }
+
   void ClearRules() {
     g_brave_browser_process->greaselion_download_service()->rules()->clear();
   }
@@ -194,6 +212,55 @@ IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, ClearCache) {
   EXPECT_EQ(size, GetRulesSize());
 }
 
+IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, RulesUpdateKeepsExtensions) {
+  ASSERT_TRUE(InstallMockExtension());
+  const std::map<std::string, base::FilePath> paths =
+      GetGreaselionExtensionPaths();
+  EXPECT_FALSE(paths.empty());
+  // Reloading the same rules must not regenerate any extension.
+  ASSERT_TRUE(InstallMockExtension());
+  EXPECT_EQ(paths, GetGreaselionExtensionPaths());
+}
+
+IN_PROC_BROWSER_TEST_F(GreaselionServiceTest,
+                       FeatureToggleRegeneratesOnlyChangedExtensions) {
+  ASSERT_TRUE(InstallMockExtension());
+  const std::map<std::string, base::FilePath> paths =
+      GetGreaselionExtensionPaths();
+
+  GreaselionService* greaselion_service =
+      GreaselionServiceFactory::GetForBrowserContext(profile());
+  greaselion_service->SetFeatureEnabled(greaselion::REWARDS, true);
+  GreaselionServiceWaiter(greaselion_service).Wait();
+
+  // Enabling rewards only adds the rule with the rewards precondition; every
+  // other extension stays loaded from where it was.
+  std::map<std::string, base::FilePath> new_paths =
+      GetGreaselionExtensionPaths();
+  ASSERT_EQ(paths.size() + 1, new_paths.size());
+  for (const auto& path : paths)
+    EXPECT_EQ(path.second, new_paths[path.first]);
+
+  greaselion_service->SetFeatureEnabled(greaselion::REWARDS, false);
+  GreaselionServiceWaiter(greaselion_service).Wait();
+  EXPECT_EQ(paths, GetGreaselionExtensionPaths());
+}
+
+IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, FeatureToggleDuringUpdate) {
+  ASSERT_TRUE(InstallMockExtension());
+  const size_t size = GetGreaselionExtensionPaths().size();
+
+  // The second toggle arrives while the first update is still running; it
+  // must be applied once that update finishes rather than dropped.
+  GreaselionService* greaselion_service =
+      GreaselionServiceFactory::GetForBrowserContext(profile());
+  greaselion_service->SetFeatureEnabled(greaselion::REWARDS, true);
+  greaselion_service->SetFeatureEnabled(greaselion::REWARDS, false);
+  greaselion_service->SetFeatureEnabled(greaselion::REWARDS, true);
+  GreaselionServiceWaiter(greaselion_service).Wait();
+  EXPECT_EQ(size + 1, GetGreaselionExtensionPaths().size());
+}
+
 IN_PROC_BROWSER_TEST_F(GreaselionServiceTest, ScriptInjection) {
   ASSERT_TRUE(InstallMockExtension());
   GURL url = embedded_test_server()->GetURL("www.a.com", "/simple.html");
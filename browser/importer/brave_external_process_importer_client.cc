@@ -99,6 +99,45 @@ void BraveExternalProcessImporterClient::OnImportItemFinished(
   brave_profile_import_->ReportImportItemFinished(import_item);
 }
 
+void BraveExternalProcessImporterClient::OnHistoryImportGroup(
+    const std::vector<ImporterURLRow>& history_rows_group,
+    int visit_source) {
+  if (!ShouldUseBraveImporter(source_profile_.importer_type)) {
+    ExternalProcessImporterClient::OnHistoryImportGroup(history_rows_group,
+                                                        visit_source);
+    return;
+  }
+
+  if (cancelled_)
+    return;
+
+  history_rows_.insert(history_rows_.end(), history_rows_group.begin(),
+                       history_rows_group.end());
+  if (history_rows_.size() >= total_history_rows_count_) {
+    bridge_->SetHistoryItems(history_rows_,
+                             static_cast<importer::VisitSource>(visit_source));
+    history_rows_.clear();
+  }
+}
+
+void BraveExternalProcessImporterClient::OnFaviconsImportGroup(
+    const favicon_base::FaviconUsageDataList& favicons_group) {
+  if (!ShouldUseBraveImporter(source_profile_.importer_type)) {
+    ExternalProcessImporterClient::OnFaviconsImportGroup(favicons_group);
+    return;
+  }
+
+  if (cancelled_)
+    return;
+
+  favicons_.insert(favicons_.end(), favicons_group.begin(),
+                   favicons_group.end());
+  if (favicons_.size() >= total_favicons_count_) {
+    bridge_->SetFavicons(favicons_);
+    favicons_.clear();
+  }
+}
+
 void BraveExternalProcessImporterClient::OnCreditCardImportReady(
     const base::string16& name_on_card,
     const base::string16& expiration_month,
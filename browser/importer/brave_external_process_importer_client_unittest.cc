@@ -0,0 +1,141 @@
+/* Copyright 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/importer/brave_external_process_importer_client.h"
+
+#include <string>
+#include <vector>
+
+#include "base/memory/scoped_refptr.h"
+#include "base/memory/weak_ptr.h"
+#include "brave/browser/importer/brave_in_process_importer_bridge.h"
+#include "chrome/browser/importer/external_process_importer_host.h"
+#include "chrome/browser/importer/profile_writer.h"
+#include "chrome/common/importer/importer_data_types.h"
+#include "chrome/common/importer/importer_url_row.h"
+#include "components/favicon_base/favicon_usage_data.h"
+#include "components/history/core/browser/history_types.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gmock/include/gmock/gmock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+using ::testing::_;
+using ::testing::SaveArg;
+
+namespace {
+
+class MockProfileWriter : public ProfileWriter {
+ public:
+  MockProfileWriter() : ProfileWriter(nullptr) {}
+
+  MOCK_METHOD2(AddHistoryPage,
+               void(const history::URLRows& page,
+                    history::VisitSource visit_source));
+  MOCK_METHOD1(AddFavicons,
+               void(const favicon_base::FaviconUsageDataList& favicons));
+
+ protected:
+  ~MockProfileWriter() override = default;
+};
+
+std::vector<ImporterURLRow> CreateHistoryRows(
+    const std::vector<std::string>& urls) {
+  std::vector<ImporterURLRow> rows;
+  for (const auto& url : urls)
+    rows.push_back(ImporterURLRow(GURL(url)));
+  return rows;
+}
+
+favicon_base::FaviconUsageDataList CreateFavicons(
+    const std::vector<std::string>& favicon_urls) {
+  favicon_base::FaviconUsageDataList favicons;
+  for (const auto& favicon_url : favicon_urls) {
+    favicon_base::FaviconUsageData favicon;
+    favicon.favicon_url = GURL(favicon_url);
+    favicons.push_back(favicon);
+  }
+  return favicons;
+}
+
+}  // namespace
+
+class BraveExternalProcessImporterClientTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    writer_ = base::MakeRefCounted<MockProfileWriter>();
+    bridge_ = base::MakeRefCounted<BraveInProcessImporterBridge>(
+        writer_.get(), base::WeakPtr<ExternalProcessImporterHost>());
+
+    importer::SourceProfile source_profile;
+    source_profile.importer_type = importer::TYPE_CHROME;
+    client_ = base::MakeRefCounted<BraveExternalProcessImporterClient>(
+        base::WeakPtr<ExternalProcessImporterHost>(), source_profile,
+        importer::HISTORY | importer::FAVORITES, bridge_.get());
+  }
+
+  content::BrowserTaskEnvironment task_environment_;
+  scoped_refptr<MockProfileWriter> writer_;
+  scoped_refptr<BraveInProcessImporterBridge> bridge_;
+  scoped_refptr<BraveExternalProcessImporterClient> client_;
+};
+
+TEST_F(BraveExternalProcessImporterClientTest, ImportHistoryInChunks) {
+  history::URLRows first_chunk;
+  history::URLRows second_chunk;
+  EXPECT_CALL(*writer_, AddHistoryPage(_, _))
+      .WillOnce(SaveArg<0>(&first_chunk))
+      .WillOnce(SaveArg<0>(&second_chunk));
+
+  // The first chunk arrives in two groups.
+  client_->OnHistoryImportStart(3);
+  client_->OnHistoryImportGroup(
+      CreateHistoryRows({"https://brave.com/", "https://github.com/brave"}),
+      importer::VISIT_SOURCE_CHROME_IMPORTED);
+  client_->OnHistoryImportGroup(
+      CreateHistoryRows({"https://www.nytimes.com/"}),
+      importer::VISIT_SOURCE_CHROME_IMPORTED);
+
+  client_->OnHistoryImportStart(1);
+  client_->OnHistoryImportGroup(
+      CreateHistoryRows({"https://example.com/"}),
+      importer::VISIT_SOURCE_CHROME_IMPORTED);
+
+  ASSERT_EQ(3u, first_chunk.size());
+  EXPECT_EQ("https://brave.com/", first_chunk[0].url().spec());
+  EXPECT_EQ("https://github.com/brave", first_chunk[1].url().spec());
+  EXPECT_EQ("https://www.nytimes.com/", first_chunk[2].url().spec());
+
+  // Rows of the first chunk are not imported again.
+  ASSERT_EQ(1u, second_chunk.size());
+  EXPECT_EQ("https://example.com/", second_chunk[0].url().spec());
+}
+
+TEST_F(BraveExternalProcessImporterClientTest, ImportFaviconsInChunks) {
+  favicon_base::FaviconUsageDataList first_chunk;
+  favicon_base::FaviconUsageDataList second_chunk;
+  EXPECT_CALL(*writer_, AddFavicons(_))
+      .WillOnce(SaveArg<0>(&first_chunk))
+      .WillOnce(SaveArg<0>(&second_chunk));
+
+  client_->OnFaviconsImportStart(2);
+  client_->OnFaviconsImportGroup(
+      CreateFavicons({"https://brave.com/favicon.ico",
+                      "https://github.com/favicon.ico"}));
+
+  client_->OnFaviconsImportStart(1);
+  client_->OnFaviconsImportGroup(
+      CreateFavicons({"https://www.nytimes.com/favicon.ico"}));
+
+  ASSERT_EQ(2u, first_chunk.size());
+  EXPECT_EQ("https://brave.com/favicon.ico",
+            first_chunk[0].favicon_url.spec());
+  EXPECT_EQ("https://github.com/favicon.ico",
+            first_chunk[1].favicon_url.spec());
+
+  ASSERT_EQ(1u, second_chunk.size());
+  EXPECT_EQ("https://www.nytimes.com/favicon.ico",
+            second_chunk[0].favicon_url.spec());
+}
@@ -15,10 +15,12 @@
 #include "third_party/blink/renderer/platform/bindings/script_state.h"
 #include "third_party/blink/renderer/platform/graphics/image_data_buffer.h"
 #include "third_party/blink/renderer/platform/graphics/static_bitmap_image.h"
+#include "third_party/blink/renderer/platform/audio/vector_math.h"
 #include "third_party/blink/renderer/platform/graphics/unaccelerated_static_bitmap_image.h"
 #include "third_party/blink/renderer/platform/heap/handle.h"
 #include "third_party/blink/renderer/platform/network/network_utils.h"
 #include "third_party/blink/renderer/platform/supplementable.h"
+#include "third_party/skia/include/core/SkImage.h"
 
 namespace {
 
@@ -36,18 +38,25 @@ float ConstantMultiplier(double fudge_factor, float value, size_t index) {
   return value * fudge_factor;
 }
 
-float PseudoRandomSequence(uint64_t seed, float value, size_t index) {
-  static uint64_t v;
+// Returns pseudo-random float between 0 and 0.1 and advances |v| to the next
+// value in the PRNG sequence.
+inline float NextPseudoRandomSample(uint64_t* v) {
   const double maxUInt64AsDouble = UINT64_MAX;
+  *v = lfsr_next(*v);
+  return (*v / maxUInt64AsDouble) / 10;
+}
+
+// |state| is owned by the callback, so each callback has its own sequence.
+float PseudoRandomSequence(uint64_t seed,
+                           uint64_t* state,
+                           float value,
+                           size_t index) {
   if (index == 0) {
     // start of loop, reset to initial seed which was passed in and is based on
     // the domain key
-    v = seed;
+    *state = seed;
   }
-  // get next value in PRNG sequence
-  v = lfsr_next(v);
-  // return pseudo-random float between 0 and 0.1
-  return (v / maxUInt64AsDouble) / 10;
+  return NextPseudoRandomSample(state);
 }
 
 }  // namespace
@@ -116,13 +125,42 @@ AudioFarblingCallback BraveSessionCache::GetAudioFarblingCallback(
       }
       case BraveFarblingLevel::MAXIMUM: {
         uint64_t seed = *reinterpret_cast<uint64_t*>(domain_key_);
-        return base::BindRepeating(&PseudoRandomSequence, seed);
+        return base::BindRepeating(&PseudoRandomSequence, seed,
+                                   base::Owned(new uint64_t(seed)));
       }
     }
   }
   return base::BindRepeating(&Identity);
 }
 
+void BraveSessionCache::FarbleAudioChannel(blink::LocalFrame* frame,
+                                           base::span<float> samples) {
+  if (samples.empty() || !farbling_enabled_ || !frame ||
+      !frame->GetContentSettingsClient()) {
+    return;
+  }
+  switch (frame->GetContentSettingsClient()->GetBraveFarblingLevel()) {
+    case BraveFarblingLevel::OFF:
+      break;
+    case BraveFarblingLevel::BALANCED: {
+      const uint64_t* fudge = reinterpret_cast<const uint64_t*>(domain_key_);
+      const double maxUInt64AsDouble = UINT64_MAX;
+      const float fudge_factor = 0.99 + ((*fudge / maxUInt64AsDouble) / 100);
+      // Audio buffers are far below 2^32 samples.
+      blink::vector_math::Vsmul(samples.data(), 1, &fudge_factor,
+                                samples.data(), 1,
+                                static_cast<uint32_t>(samples.size()));
+      break;
+    }
+    case BraveFarblingLevel::MAXIMUM: {
+      uint64_t v = *reinterpret_cast<uint64_t*>(domain_key_);
+      for (float& sample : samples)
+        sample = NextPseudoRandomSample(&v);
+      break;
+    }
+  }
+}
+
 scoped_refptr<blink::StaticBitmapImage> BraveSessionCache::PerturbPixels(
     blink::LocalFrame* frame,
     scoped_refptr<blink::StaticBitmapImage> image_bitmap) {
@@ -149,6 +187,14 @@ BraveSessionCache::PerturbPixelsInternal(
   DCHECK(image_bitmap);
   if (image_bitmap->IsNull())
     return image_bitmap;
+  const sk_sp<SkImage> source_image =
+      image_bitmap->PaintImageForCurrentFrame().GetSkImage();
+  const uint32_t source_image_id = source_image ? source_image->uniqueID() : 0;
+  if (source_image_id != 0 &&
+      source_image_id == last_perturbed_source_image_id_) {
+    DCHECK(last_perturbed_image_);
+    return last_perturbed_image_;
+  }
   // convert to an ImageDataBuffer to normalize the pixel data to RGBA, 4 bytes
   // per pixel
   std::unique_ptr<blink::ImageDataBuffer> data_buffer =
@@ -191,6 +237,8 @@ BraveSessionCache::PerturbPixelsInternal(
   scoped_refptr<blink::StaticBitmapImage> perturbed_bitmap =
       blink::UnacceleratedStaticBitmapImage::Create(
           data_buffer->RetainedImage());
+  last_perturbed_source_image_id_ = source_image_id;
+  last_perturbed_image_ = perturbed_bitmap;
   return perturbed_bitmap;
 }
 
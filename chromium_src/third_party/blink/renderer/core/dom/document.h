@@ -11,6 +11,7 @@
 #include <random>
 
 #include "base/callback.h"
+#include "base/containers/span.h"
 
 using blink::Document;
 using blink::GarbageCollected;
@@ -43,6 +44,9 @@ class CORE_EXPORT BraveSessionCache final
   static BraveSessionCache& From(Document&);
 
   AudioFarblingCallback GetAudioFarblingCallback(blink::LocalFrame* frame);
+  // Farbles |samples| in place. Called on every read of a channel, as audio
+  // buffers can be refilled between reads.
+  void FarbleAudioChannel(blink::LocalFrame* frame, base::span<float> samples);
   scoped_refptr<blink::StaticBitmapImage> PerturbPixels(
       blink::LocalFrame* frame,
       scoped_refptr<blink::StaticBitmapImage> image_bitmap);
@@ -54,6 +58,12 @@ class CORE_EXPORT BraveSessionCache final
   uint64_t session_key_;
   uint8_t domain_key_[32];
 
+  // The last perturbed canvas image, keyed by the unique ID of the source
+  // SkImage. Snapshots of an unchanged canvas share one immutable SkImage, so
+  // repeated exports reuse the perturbed result.
+  uint32_t last_perturbed_source_image_id_ = 0;
+  scoped_refptr<blink::StaticBitmapImage> last_perturbed_image_;
+
   scoped_refptr<blink::StaticBitmapImage> PerturbPixelsInternal(
       scoped_refptr<blink::StaticBitmapImage> image_bitmap);
 };
@@ -11,12 +11,35 @@
 #include <utility>
 
 #include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
 
 namespace brave_perf_predictor {
 
 namespace {
 
+constexpr char kThirdPartiesPrefix[] = "thirdParties.";
+constexpr char kBlockedSuffix[] = ".blocked";
+
+base::flat_map<std::string, size_t> BuildThirdPartyBlockedFeatureIndex() {
+  std::vector<std::pair<std::string, size_t>> entries;
+  for (size_t i = kThirdPartiesBlockedBegin; i < feature_count; i++) {
+    base::StringPiece name = feature_sequence[i];
+    if (!base::StartsWith(name, kThirdPartiesPrefix,
+                          base::CompareCase::SENSITIVE) ||
+        !base::EndsWith(name, kBlockedSuffix, base::CompareCase::SENSITIVE)) {
+      NOTREACHED() << "Unexpected feature " << name;
+      continue;
+    }
+    name.remove_prefix(sizeof(kThirdPartiesPrefix) - 1);
+    name.remove_suffix(sizeof(kBlockedSuffix) - 1);
+    entries.emplace_back(name.as_string(), i);
+  }
+  return base::flat_map<std::string, size_t>(std::move(entries));
+}
+
 bool StandardiseFeatsNoOutliers(
     std::array<double, standardise_feat_count>* features,
     const std::array<double, standardise_feat_count>& means,
@@ -37,6 +60,16 @@ bool StandardiseFeatsNoOutliers(
 
 }  // namespace
 
+base::Optional<size_t> GetThirdPartyBlockedFeatureIndex(
+    base::StringPiece third_party_name) {
+  static const base::NoDestructor<base::flat_map<std::string, size_t>> index(
+      BuildThirdPartyBlockedFeatureIndex());
+  const auto it = index->find(third_party_name);
+  if (it == index->end())
+    return base::nullopt;
+  return it->second;
+}
+
 double LinregPredictVector(const std::array<double, feature_count>& features) {
   // Standardise numeric features
   std::array<double, standardise_feat_count> numeric_features;
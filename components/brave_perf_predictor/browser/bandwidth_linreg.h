@@ -10,6 +10,8 @@
 #include <vector>
 
 #include "base/containers/flat_map.h"
+#include "base/optional.h"
+#include "base/strings/string_piece.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
 
 namespace brave_perf_predictor {
@@ -18,6 +20,40 @@ constexpr double kOutlierThreshold = 6;
 // if above 20MB _and_ more than 6x of the transfer size, probably an outlier
 constexpr double kSavingsAbsoluteOutlier = 20 << 20;
 
+// Positions of the fixed features in |feature_sequence|. The per-entity
+// "thirdParties.<name>.blocked" features follow |kThirdPartiesBlockedBegin|.
+enum FeatureIndex : size_t {
+  kAdblockRequests = 0,
+  kFirstMeaningfulPaint,
+  kObservedDomContentLoaded,
+  kObservedFirstVisualChange,
+  kObservedLoad,
+  kDocumentRequestCount,
+  kDocumentSize,
+  kFontRequestCount,
+  kFontSize,
+  kImageRequestCount,
+  kImageSize,
+  kMediaRequestCount,
+  kMediaSize,
+  kOtherRequestCount,
+  kOtherSize,
+  kScriptRequestCount,
+  kScriptSize,
+  kStylesheetRequestCount,
+  kStylesheetSize,
+  kThirdPartyRequestCount,
+  kThirdPartySize,
+  kTotalRequestCount,
+  kTotalSize,
+  kThirdPartiesBlockedBegin,
+};
+
+// Returns the index of the "thirdParties.<name>.blocked" feature for the
+// named third party, or nullopt if the model does not use it.
+base::Optional<size_t> GetThirdPartyBlockedFeatureIndex(
+    base::StringPiece third_party_name);
+
 // Computes prediction based on the provided feature vector.
 // It is the client's responsibility to provide features in
 // the exact order expected by the predictor.
@@ -104,4 +104,27 @@ TEST(BraveSavingsPredictorTest, HandesSpecificFeaturemapExample) {
             794);  // Equal on the order of thousands
 }
 
+TEST(BraveSavingsPredictorTest, FeatureIndexMatchesFeatureSequence) {
+  EXPECT_EQ(feature_sequence[kAdblockRequests], "adblockRequests");
+  EXPECT_EQ(feature_sequence[kObservedLoad], "metrics.observedLoad");
+  EXPECT_EQ(feature_sequence[kDocumentSize], "resources.document.size");
+  EXPECT_EQ(feature_sequence[kStylesheetRequestCount],
+            "resources.stylesheet.requestCount");
+  EXPECT_EQ(feature_sequence[kThirdPartySize], "resources.third-party.size");
+  EXPECT_EQ(feature_sequence[kTotalSize], "resources.total.size");
+  EXPECT_EQ(static_cast<unsigned int>(kThirdPartiesBlockedBegin),
+            standardise_feat_count);
+}
+
+TEST(BraveSavingsPredictorTest, GetsThirdPartyBlockedFeatureIndex) {
+  for (unsigned int i = kThirdPartiesBlockedBegin; i < feature_count; i++) {
+    const std::string& name = feature_sequence[i];
+    const std::string third_party =
+        name.substr(13, name.size() - 13 - 8);  // "thirdParties." ".blocked"
+    EXPECT_EQ(GetThirdPartyBlockedFeatureIndex(third_party), i) << name;
+  }
+  EXPECT_FALSE(GetThirdPartyBlockedFeatureIndex("Unknown Party").has_value());
+  EXPECT_FALSE(GetThirdPartyBlockedFeatureIndex("adblockRequests").has_value());
+}
+
 }  // namespace brave_perf_predictor
@@ -7,10 +7,10 @@
 
 #include <memory>
 
-#include "base/containers/flat_map.h"
 #include "base/run_loop.h"
 #include "base/test/task_environment.h"
 #include "base/time/time.h"
+#include "brave/components/brave_perf_predictor/browser/bandwidth_linreg.h"
 #include "chrome/browser/predictors/loading_test_util.h"
 #include "components/page_load_metrics/common/page_load_metrics.mojom.h"
 #include "components/page_load_metrics/common/page_load_timing.h"
@@ -39,45 +39,46 @@ class BandwidthSavingsPredictorTest : public ::testing::Test {
 
 TEST_F(BandwidthSavingsPredictorTest, FeaturiseBlocked) {
   predictor_->OnSubresourceBlocked("https://google-analytics.com");
-  EXPECT_EQ(predictor_->feature_map_["adblockRequests"], 1);
-  EXPECT_EQ(predictor_->feature_map_["thirdParties.Google Analytics.blocked"],
-            1);
+  EXPECT_EQ(predictor_->features_[kAdblockRequests], 1);
+  const auto ga_index = GetThirdPartyBlockedFeatureIndex("Google Analytics");
+  ASSERT_TRUE(ga_index.has_value());
+  EXPECT_EQ(predictor_->features_[ga_index.value()], 1);
   predictor_->OnSubresourceBlocked("https://test.m.facebook.com");
-  EXPECT_EQ(predictor_->feature_map_["adblockRequests"], 2);
+  EXPECT_EQ(predictor_->features_[kAdblockRequests], 2);
 }
 
 TEST_F(BandwidthSavingsPredictorTest, FeaturiseTiming) {
   const auto empty_timing = page_load_metrics::CreatePageLoadTiming();
   predictor_->OnPageLoadTimingUpdated(*empty_timing);
-  EXPECT_EQ(predictor_->feature_map_["metrics.firstMeaningfulPaint"], 0);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedDomContentLoaded"], 0);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedFirstVisualChange"], 0);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedLoad"], 0);
+  EXPECT_EQ(predictor_->features_[kFirstMeaningfulPaint], 0);
+  EXPECT_EQ(predictor_->features_[kObservedDomContentLoaded], 0);
+  EXPECT_EQ(predictor_->features_[kObservedFirstVisualChange], 0);
+  EXPECT_EQ(predictor_->features_[kObservedLoad], 0);
 
   auto timing = page_load_metrics::CreatePageLoadTiming();
   timing->document_timing->dom_content_loaded_event_start =
       base::TimeDelta::FromMilliseconds(1000);
   predictor_->OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedDomContentLoaded"], 1000);
+  EXPECT_EQ(predictor_->features_[kObservedDomContentLoaded], 1000);
 
   timing->document_timing->load_event_start =
       base::TimeDelta::FromMilliseconds(2000);
   predictor_->OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedLoad"], 2000);
+  EXPECT_EQ(predictor_->features_[kObservedLoad], 2000);
 
   timing->paint_timing->first_meaningful_paint =
       base::TimeDelta::FromMilliseconds(1500);
   predictor_->OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor_->feature_map_["metrics.firstMeaningfulPaint"], 1500);
+  EXPECT_EQ(predictor_->features_[kFirstMeaningfulPaint], 1500);
 
   timing->paint_timing->first_contentful_paint =
       base::TimeDelta::FromMilliseconds(800);
   predictor_->OnPageLoadTimingUpdated(*timing);
-  EXPECT_EQ(predictor_->feature_map_["metrics.observedFirstVisualChange"], 800);
+  EXPECT_EQ(predictor_->features_[kObservedFirstVisualChange], 800);
 }
 
 TEST_F(BandwidthSavingsPredictorTest, FeaturiseResourceLoading) {
-  EXPECT_EQ(predictor_->feature_map_["resources.third-party.requestCount"], 0);
+  EXPECT_EQ(predictor_->features_[kThirdPartyRequestCount], 0);
 
   const GURL main_frame("https://brave.com/");
 
@@ -86,9 +87,9 @@ TEST_F(BandwidthSavingsPredictorTest, FeaturiseResourceLoading) {
       network::mojom::RequestDestination::kStyle);
   fp_style->raw_body_bytes = 1000;
   predictor_->OnResourceLoadComplete(main_frame, *fp_style);
-  EXPECT_EQ(predictor_->feature_map_["resources.third-party.requestCount"], 0);
-  EXPECT_EQ(predictor_->feature_map_["resources.stylesheet.requestCount"], 1);
-  EXPECT_EQ(predictor_->feature_map_["resources.stylesheet.size"], 1000);
+  EXPECT_EQ(predictor_->features_[kThirdPartyRequestCount], 0);
+  EXPECT_EQ(predictor_->features_[kStylesheetRequestCount], 1);
+  EXPECT_EQ(predictor_->features_[kStylesheetSize], 1000);
 
   auto tp_style = predictors::CreateResourceLoadInfo(
       "https://stackpath.bootstrapcdn.com/bootstrap/4.4.1/css/bootstrap.min.js",
@@ -96,14 +97,14 @@ TEST_F(BandwidthSavingsPredictorTest, FeaturiseResourceLoading) {
   tp_style->raw_body_bytes = 1001;
   predictor_->OnResourceLoadComplete(main_frame, *tp_style);
 
-  EXPECT_EQ(predictor_->feature_map_["resources.third-party.requestCount"], 1);
-  EXPECT_EQ(predictor_->feature_map_["resources.stylesheet.requestCount"], 1);
-  EXPECT_EQ(predictor_->feature_map_["resources.script.requestCount"], 1);
-  EXPECT_EQ(predictor_->feature_map_["resources.stylesheet.size"], 1000);
-  EXPECT_EQ(predictor_->feature_map_["resources.script.size"], 1001);
+  EXPECT_EQ(predictor_->features_[kThirdPartyRequestCount], 1);
+  EXPECT_EQ(predictor_->features_[kStylesheetRequestCount], 1);
+  EXPECT_EQ(predictor_->features_[kScriptRequestCount], 1);
+  EXPECT_EQ(predictor_->features_[kStylesheetSize], 1000);
+  EXPECT_EQ(predictor_->features_[kScriptSize], 1001);
 
-  EXPECT_EQ(predictor_->feature_map_["resources.total.requestCount"], 2);
-  EXPECT_EQ(predictor_->feature_map_["resources.total.size"], 2001);
+  EXPECT_EQ(predictor_->features_[kTotalRequestCount], 2);
+  EXPECT_EQ(predictor_->features_[kTotalSize], 2001);
 }
 
 TEST_F(BandwidthSavingsPredictorTest, PredictZeroNoData) {
@@ -5,7 +5,8 @@
 
 #include "brave/components/brave_perf_predictor/browser/named_third_party_registry.h"
 
-#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "base/bind.h"
 #include "base/containers/flat_set.h"
@@ -27,11 +28,11 @@ namespace brave_perf_predictor {
 
 namespace {
 
-std::tuple<base::flat_map<std::string, std::string>,
-           base::flat_map<std::string, std::string>>
-ParseMappings(const base::StringPiece entities, bool discard_irrelevant) {
-  base::flat_map<std::string, std::string> entity_by_domain;
-  base::flat_map<std::string, std::string> entity_by_root_domain;
+ThirdPartyEntityMappings ParseMappings(const base::StringPiece entities,
+                                       bool discard_irrelevant) {
+  ThirdPartyEntityMappings mappings;
+  std::vector<std::pair<std::string, uint32_t>> entity_by_domain;
+  base::flat_map<std::string, uint32_t> entity_index;
 
   // Parse the JSON
   base::Optional<base::Value> document = base::JSONReader::Read(entities);
@@ -53,40 +54,54 @@ ParseMappings(const base::StringPiece entities, bool discard_irrelevant) {
     if (!entity_domains)
       continue;
 
+    // Intern the entity name
+    const auto interned = entity_index.emplace(
+        *entity_name, static_cast<uint32_t>(mappings.entity_names.size()));
+    if (interned.second)
+      mappings.entity_names.push_back(*entity_name);
+    const uint32_t entity_id = interned.first->second;
+
     for (auto& entity_domain_it : entity_domains->GetList()) {
       if (!entity_domain_it.is_string()) {
         continue;
       }
       const base::StringPiece entity_domain(entity_domain_it.GetString());
+      entity_by_domain.emplace_back(entity_domain.as_string(), entity_id);
 
-      const auto inserted =
-          entity_by_domain.emplace(entity_domain, *entity_name);
-      if (!inserted.second) {
-        VLOG(2) << "Malformed data: duplicate domain " << entity_domain;
-      }
       auto root_domain = net::registry_controlled_domains::GetDomainAndRegistry(
           entity_domain,
           net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+      if (root_domain.empty())
+        continue;
 
-      auto root_entity_entry = entity_by_root_domain.find(root_domain);
-      if (root_entity_entry != entity_by_root_domain.end() &&
-          root_entity_entry->second != *entity_name) {
+      auto root_entity_entry = mappings.entity_by_root_domain.find(root_domain);
+      if (root_entity_entry != mappings.entity_by_root_domain.end() &&
+          root_entity_entry->second != entity_id) {
         // If there is a clash at root domain level, neither is correct
-        entity_by_root_domain.erase(root_entity_entry);
+        mappings.entity_by_root_domain.erase(root_entity_entry);
       } else {
-        entity_by_root_domain.emplace(root_domain, *entity_name);
+        mappings.entity_by_root_domain.emplace(std::move(root_domain),
+                                               entity_id);
       }
     }
   }
 
-  entity_by_domain.shrink_to_fit();
-  entity_by_root_domain.shrink_to_fit();
-  return std::make_tuple(entity_by_domain, entity_by_root_domain);
+  // Build the domain table in one go; the first entity listing a domain wins
+  const size_t domain_count = entity_by_domain.size();
+  mappings.entity_by_domain = base::flat_map<std::string, uint32_t>(
+      std::move(entity_by_domain), base::KEEP_FIRST_OF_DUPES);
+  if (mappings.entity_by_domain.size() != domain_count) {
+    VLOG(2) << "Malformed data: "
+            << domain_count - mappings.entity_by_domain.size()
+            << " duplicate domains";
+  }
+
+  mappings.entity_names.shrink_to_fit();
+  mappings.entity_by_root_domain.shrink_to_fit();
+  return mappings;
 }
 
-std::tuple<base::flat_map<std::string, std::string>,
-           base::flat_map<std::string, std::string>>
-ParseFromResource(int resource_id) {
+ThirdPartyEntityMappings ParseFromResource(int resource_id) {
   // TODO(AndriusA): insert trace event here
   SCOPED_UMA_HISTOGRAM_TIMER(
       "Brave.Savings.NamedThirdPartyRegistry.LoadTimeMS");
@@ -99,16 +114,22 @@ ParseFromResource(int resource_id) {
 
 }  // namespace
 
+ThirdPartyEntityMappings::ThirdPartyEntityMappings() = default;
+ThirdPartyEntityMappings::~ThirdPartyEntityMappings() = default;
+ThirdPartyEntityMappings::ThirdPartyEntityMappings(
+    ThirdPartyEntityMappings&&) = default;
+ThirdPartyEntityMappings& ThirdPartyEntityMappings::operator=(
+    ThirdPartyEntityMappings&&) = default;
+
 bool NamedThirdPartyRegistry::LoadMappings(const base::StringPiece entities,
                                            bool discard_irrelevant) {
   // Reset previous mappings
-  entity_by_domain_.clear();
-  entity_by_root_domain_.clear();
+  mappings_ = {};
   initialized_ = false;
 
-  tie(entity_by_domain_, entity_by_root_domain_) =
-      ParseMappings(entities, discard_irrelevant);
-  if (entity_by_domain_.size() == 0 || entity_by_root_domain_.size() == 0)
+  mappings_ = ParseMappings(entities, discard_irrelevant);
+  if (mappings_.entity_by_domain.size() == 0 ||
+      mappings_.entity_by_root_domain.size() == 0)
     return false;
 
   initialized_ = true;
@@ -116,15 +137,16 @@ bool NamedThirdPartyRegistry::LoadMappings(const base::StringPiece entities,
 }
 
 void NamedThirdPartyRegistry::UpdateMappings(
-    std::tuple<base::flat_map<std::string, std::string>,
-               base::flat_map<std::string, std::string>> entity_mappings) {
-  tie(entity_by_domain_, entity_by_root_domain_) = entity_mappings;
-  VLOG(2) << "Loaded " << entity_by_domain_.size() << " mappings by domain and "
-          << entity_by_root_domain_.size() << " by root domain; size";
+    ThirdPartyEntityMappings entity_mappings) {
+  mappings_ = std::move(entity_mappings);
+  VLOG(2) << "Loaded " << mappings_.entity_by_domain.size()
+          << " mappings by domain and "
+          << mappings_.entity_by_root_domain.size() << " by root domain for "
+          << mappings_.entity_names.size() << " entities";
   initialized_ = true;
 }
 
-base::Optional<std::string> NamedThirdPartyRegistry::GetThirdParty(
+base::Optional<base::StringPiece> NamedThirdPartyRegistry::GetThirdParty(
     const base::StringPiece request_url) const {
   if (!IsInitialized()) {
     VLOG(2) << "Named Third Party Registry not initialized";
@@ -132,20 +154,26 @@ base::Optional<std::string> NamedThirdPartyRegistry::GetThirdParty(
   }
 
   const GURL url(request_url);
-  if (!url.is_valid())
+  if (!url.is_valid() || !url.has_host())
     return base::nullopt;
 
-  if (url.has_host()) {
-    auto domain_entry = entity_by_domain_.find(url.host());
-    if (domain_entry != entity_by_domain_.end())
-      return domain_entry->second;
+  base::StringPiece host = url.host_piece();
+  const auto domain_entry = mappings_.entity_by_domain.find(host);
+  if (domain_entry != mappings_.entity_by_domain.end())
+    return base::StringPiece(mappings_.entity_names[domain_entry->second]);
 
-    auto root_domain = net::registry_controlled_domains::GetDomainAndRegistry(
-        url, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
-
-    auto root_domain_entry = entity_by_root_domain_.find(root_domain);
-    if (root_domain_entry != entity_by_root_domain_.end())
-      return root_domain_entry->second;
+  // The root domain table is keyed by registrable domain, which is always a
+  // suffix of the host: walk the host suffixes label by label instead of
+  // computing it.
+  if (url.HostIsIPAddress())
+    return base::nullopt;
+  for (size_t dot = host.find('.'); dot != base::StringPiece::npos;
+       dot = host.find('.')) {
+    const auto root_domain_entry = mappings_.entity_by_root_domain.find(host);
+    if (root_domain_entry != mappings_.entity_by_root_domain.end())
+      return base::StringPiece(
+          mappings_.entity_names[root_domain_entry->second]);
+    host.remove_prefix(dot + 1);
   }
 
   return base::nullopt;
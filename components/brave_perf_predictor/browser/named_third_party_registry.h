@@ -6,16 +6,32 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_REGISTRY_H_
 #define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_REGISTRY_H_
 
+#include <stdint.h>
+
 #include <string>
-#include <tuple>
+#include <vector>
 
 #include "base/containers/flat_map.h"
 #include "base/memory/weak_ptr.h"
-#include "base/values.h"
+#include "base/optional.h"
+#include "base/strings/string_piece.h"
 #include "components/keyed_service/core/keyed_service.h"
 
 namespace brave_perf_predictor {
 
+// Domain to entity mappings. Entity names are stored once in |entity_names|
+// and the domain tables refer to them by index.
+struct ThirdPartyEntityMappings {
+  ThirdPartyEntityMappings();
+  ~ThirdPartyEntityMappings();
+  ThirdPartyEntityMappings(ThirdPartyEntityMappings&&);
+  ThirdPartyEntityMappings& operator=(ThirdPartyEntityMappings&&);
+
+  std::vector<std::string> entity_names;
+  base::flat_map<std::string, uint32_t> entity_by_domain;
+  base::flat_map<std::string, uint32_t> entity_by_root_domain;
+};
+
 // Retrieves publicly known Third Party (organisation) for a given URL, using
 // data from the Third Party Web repository
 // (https://github.com/patrickhulce/third-party-web).
@@ -33,19 +49,18 @@ class NamedThirdPartyRegistry : public KeyedService {
   bool LoadMappings(const base::StringPiece entities, bool discard_irrelevant);
   // Default initialization - asynchronously load from bundled resource
   void InitializeDefault();
-  base::Optional<std::string> GetThirdParty(
-      const base::StringPiece domain) const;
+  // Returns the entity name for |request_url|. The returned piece refers to
+  // the registry's storage and is only valid until the mappings are reloaded.
+  base::Optional<base::StringPiece> GetThirdParty(
+      const base::StringPiece request_url) const;
 
  private:
   bool IsInitialized() const { return initialized_; }
   void MarkInitialized(bool initialized) { initialized_ = initialized; }
-  void UpdateMappings(
-      std::tuple<base::flat_map<std::string, std::string>,
-                 base::flat_map<std::string, std::string>> entity_mappings);
+  void UpdateMappings(ThirdPartyEntityMappings entity_mappings);
 
   bool initialized_ = false;
-  base::flat_map<std::string, std::string> entity_by_domain_;
-  base::flat_map<std::string, std::string> entity_by_root_domain_;
+  ThirdPartyEntityMappings mappings_;
 
   base::WeakPtrFactory<NamedThirdPartyRegistry> weak_factory_{this};
 };
@@ -119,4 +119,28 @@ TEST(NamedThirdPartyRegistryTest, HandlesUnrecognisedThirdPartyTest) {
   EXPECT_FALSE(entity.has_value());
 }
 
+TEST(NamedThirdPartyRegistryTest, HandlesRootDomainClashTest) {
+  NamedThirdPartyRegistry* extractor = new NamedThirdPartyRegistry();
+  extractor->LoadMappings(R"([
+    {"name":"A","domains":["a.shared.com","cdn.a.com"]},
+    {"name":"B","domains":["b.shared.com","b.com"]},
+    {"name":"A","domains":["a.net"]}
+  ])",
+                          false);
+  auto entity = extractor->GetThirdParty("https://a.shared.com/x.js");
+  ASSERT_TRUE(entity.has_value());
+  EXPECT_EQ(entity.value(), "A");
+  EXPECT_FALSE(extractor->GetThirdParty("https://c.shared.com").has_value());
+
+  entity = extractor->GetThirdParty("https://x.y.a.com");
+  ASSERT_TRUE(entity.has_value());
+  EXPECT_EQ(entity.value(), "A");
+  entity = extractor->GetThirdParty("https://www.a.net");
+  ASSERT_TRUE(entity.has_value());
+  EXPECT_EQ(entity.value(), "A");
+  entity = extractor->GetThirdParty("https://b.com");
+  ASSERT_TRUE(entity.has_value());
+  EXPECT_EQ(entity.value(), "B");
+}
+
 }  // namespace brave_perf_predictor
@@ -5,7 +5,11 @@
 
 #include "brave/components/content_settings/core/browser/brave_content_settings_pref_provider.h"
 
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <tuple>
 #include <utility>
 
 #include "base/bind.h"
@@ -58,15 +62,17 @@ Rule CloneRule(const Rule& rule, bool reverse_patterns = false) {
               rule.expiration, rule.session_model);
 }
 
+using CookieRules = base::RefCountedData<std::vector<Rule>>;
+
 class BraveShieldsRuleIterator : public RuleIterator {
  public:
-  explicit BraveShieldsRuleIterator(std::vector<Rule> rules)
+  explicit BraveShieldsRuleIterator(scoped_refptr<const CookieRules> rules)
       : rules_(std::move(rules)) {
-    iterator_ = rules_.begin();
+    iterator_ = rules_->data.begin();
   }
 
   bool HasNext() const override {
-    return iterator_ != rules_.end();
+    return iterator_ != rules_->data.end();
   }
 
   Rule Next() override {
@@ -74,15 +80,65 @@ class BraveShieldsRuleIterator : public RuleIterator {
   }
 
  private:
-  std::vector<Rule> rules_;
+  scoped_refptr<const CookieRules> rules_;
   std::vector<Rule>::const_iterator iterator_;
 
   DISALLOW_COPY_AND_ASSIGN(BraveShieldsRuleIterator);
 };
 
+// Shield rules, indexed by the host of their primary pattern.
+class ShieldRules {
+ public:
+  explicit ShieldRules(std::vector<Rule> rules) : rules_(std::move(rules)) {
+    for (size_t i = 0; i < rules_.size(); ++i)
+      rules_by_host_[rules_[i].primary_pattern.GetHost()].push_back(i);
+  }
+
+  const std::vector<Rule>& rules() const { return rules_; }
+
+  // Returns the first rule, in iteration order, whose primary pattern is
+  // identical to or a successor of |pattern|. Such a pattern's host is either
+  // |pattern|'s host, one of its parent domains or a wildcard, so only those
+  // rules are compared.
+  const Rule* FindFirstCovering(const ContentSettingsPattern& pattern) const {
+    const std::string host = pattern.GetHost();
+    size_t first_index = rules_.size();
+    auto find_in_host = [&](const std::string& candidate_host) {
+      const auto it = rules_by_host_.find(candidate_host);
+      if (it == rules_by_host_.end())
+        return;
+      for (size_t index : it->second) {
+        if (index >= first_index)
+          break;
+        const auto relation = rules_[index].primary_pattern.Compare(pattern);
+        // TODO(bridiver) - verify that SUCCESSOR is correct and not PREDECESSOR
+        if (relation == ContentSettingsPattern::IDENTITY ||
+            relation == ContentSettingsPattern::SUCCESSOR) {
+          first_index = index;
+          break;
+        }
+      }
+    };
+
+    find_in_host(host);
+    for (size_t dot = host.find('.'); dot != std::string::npos;
+         dot = host.find('.', dot + 1)) {
+      find_in_host(host.substr(dot + 1));
+    }
+    if (!host.empty())
+      find_in_host(std::string());
+
+    return first_index < rules_.size() ? &rules_[first_index] : nullptr;
+  }
 
-bool IsActive(const Rule& cookie_rule,
-              const std::vector<Rule>& shield_rules) {
+ private:
+  std::vector<Rule> rules_;
+  std::map<std::string, std::vector<size_t>> rules_by_host_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShieldRules);
+};
+
+bool IsActive(const Rule& cookie_rule, const ShieldRules& shield_rules) {
   // don't include default rules in the iterator
   if (cookie_rule.primary_pattern == ContentSettingsPattern::Wildcard() &&
       (cookie_rule.secondary_pattern == ContentSettingsPattern::Wildcard() ||
@@ -92,16 +148,11 @@ bool IsActive(const Rule& cookie_rule,
   }
 
   bool default_value = true;
-  for (const auto& shield_rule : shield_rules) {
-    auto primary_compare =
-        shield_rule.primary_pattern.Compare(cookie_rule.primary_pattern);
-    // TODO(bridiver) - verify that SUCCESSOR is correct and not PREDECESSOR
-    if (primary_compare == ContentSettingsPattern::IDENTITY ||
-        primary_compare == ContentSettingsPattern::SUCCESSOR) {
-      // TODO(bridiver) - move this logic into shields_util for allow/block
-      return
-          ValueToContentSetting(&shield_rule.value) != CONTENT_SETTING_BLOCK;
-    }
+  const Rule* shield_rule =
+      shield_rules.FindFirstCovering(cookie_rule.primary_pattern);
+  if (shield_rule) {
+    // TODO(bridiver) - move this logic into shields_util for allow/block
+    return ValueToContentSetting(&shield_rule->value) != CONTENT_SETTING_BLOCK;
   }
 
   return default_value;
@@ -287,14 +338,8 @@ std::unique_ptr<RuleIterator> BravePrefProvider::GetRuleIterator(
       const ResourceIdentifier& resource_identifier,
       bool incognito) const {
   if (content_type == ContentSettingsType::COOKIES) {
-    std::vector<Rule> rules;
-    for (auto i = cookie_rules_.at(incognito).begin();
-         i != cookie_rules_.at(incognito).end();
-         ++i) {
-      rules.emplace_back(CloneRule(*i));
-    }
-
-    return std::make_unique<BraveShieldsRuleIterator>(std::move(rules));
+    return std::make_unique<BraveShieldsRuleIterator>(
+        cookie_rules_.at(incognito));
   }
 
   // Early return. We don't store flash plugin setting in preference.
@@ -309,10 +354,9 @@ std::unique_ptr<RuleIterator> BravePrefProvider::GetRuleIterator(
 
 void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
                                           bool incognito) {
-  auto& rules = cookie_rules_[incognito];
+  std::vector<Rule> rules;
   auto old_rules = std::move(brave_cookie_rules_[incognito]);
 
-  rules.clear();
   brave_cookie_rules_[incognito].clear();
 
   // kGoogleLoginControlType preference adds an exception for
@@ -363,12 +407,13 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
       incognito);
 
   // collect shield rules
-  std::vector<Rule> shield_rules;
+  std::vector<Rule> shield_rule_list;
   while (brave_shields_iterator && brave_shields_iterator->HasNext()) {
-    shield_rules.emplace_back(CloneRule(brave_shields_iterator->Next()));
+    shield_rule_list.emplace_back(brave_shields_iterator->Next());
   }
 
   brave_shields_iterator.reset();
+  const ShieldRules shield_rules(std::move(shield_rule_list));
 
   // add brave cookies after checking shield status
   auto brave_cookies_iterator = PrefProvider::GetRuleIterator(
@@ -386,7 +431,7 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
   }
 
   // Adding shields down rules (they always override cookie rules).
-  for (const auto& shield_rule : shield_rules) {
+  for (const auto& shield_rule : shield_rules.rules()) {
     // There is no global shields rule
     if (shield_rule.primary_pattern.MatchesAllHosts())
       NOTREACHED();
@@ -408,37 +453,36 @@ void BravePrefProvider::UpdateCookieRules(ContentSettingsType content_type,
     }
   }
 
+  cookie_rules_[incognito] =
+      base::MakeRefCounted<CookieRules>(std::move(rules));
+
   // get the list of changes
+  // we want an exact match here because any change to the rule is an update
+  std::set<std::tuple<ContentSettingsPattern, ContentSettingsPattern,
+                      ContentSetting>> old_rule_keys;
+  for (const auto& old_rule : old_rules) {
+    old_rule_keys.emplace(old_rule.primary_pattern, old_rule.secondary_pattern,
+                          ValueToContentSetting(&old_rule.value));
+  }
   std::vector<Rule> brave_cookie_updates;
+  std::set<std::pair<ContentSettingsPattern, ContentSettingsPattern>>
+      new_rule_patterns;
   for (const auto& new_rule : brave_cookie_rules_[incognito]) {
-    auto match = std::find_if(
-        old_rules.begin(),
-        old_rules.end(),
-        [&new_rule](const auto& old_rule) {
-          // we want an exact match here because any change to the rule
-          // is an update
-          return new_rule.primary_pattern == old_rule.primary_pattern &&
-                 new_rule.secondary_pattern == old_rule.secondary_pattern &&
-                 ValueToContentSetting(&new_rule.value) ==
-                    ValueToContentSetting(&old_rule.value);
-        });
-    if (match == old_rules.end()) {
+    new_rule_patterns.emplace(new_rule.primary_pattern,
+                              new_rule.secondary_pattern);
+    if (!old_rule_keys.count(std::make_tuple(
+            new_rule.primary_pattern, new_rule.secondary_pattern,
+            ValueToContentSetting(&new_rule.value)))) {
       brave_cookie_updates.emplace_back(CloneRule(new_rule));
     }
   }
 
   // find any removed rules
+  // we only care about the patterns here because we're looking for deleted
+  // rules, not changed rules
   for (const auto& old_rule : old_rules) {
-    auto match = std::find_if(
-        brave_cookie_rules_[incognito].begin(),
-        brave_cookie_rules_[incognito].end(),
-        [&old_rule](const auto& new_rule) {
-          // we only care about the patterns here because we're looking
-          // for deleted rules, not changed rules
-          return new_rule.primary_pattern == old_rule.primary_pattern &&
-                 new_rule.secondary_pattern == old_rule.secondary_pattern;
-        });
-    if (match == brave_cookie_rules_[incognito].end()) {
+    if (!new_rule_patterns.count(std::make_pair(old_rule.primary_pattern,
+                                                old_rule.secondary_pattern))) {
       brave_cookie_updates.emplace_back(
           Rule(old_rule.primary_pattern, old_rule.secondary_pattern,
                base::Value(), old_rule.expiration, old_rule.session_model));
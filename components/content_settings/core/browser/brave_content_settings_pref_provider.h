@@ -11,6 +11,7 @@
 #include <string>
 #include <vector>
 
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "components/content_settings/core/browser/content_settings_observer.h"
 #include "components/content_settings/core/browser/content_settings_pref_provider.h"
@@ -72,7 +73,10 @@ class BravePrefProvider : public PrefProvider,
   // PrefProvider::pref_change_registrar_ alreay has plugin type.
   PrefChangeRegistrar brave_pref_change_registrar_;
 
-  std::map<bool /* is_incognito */, std::vector<Rule>> cookie_rules_;
+  // Immutable snapshots of the cookie rules, shared with the rule iterators.
+  std::map<bool /* is_incognito */,
+           scoped_refptr<const base::RefCountedData<std::vector<Rule>>>>
+      cookie_rules_;
   std::map<bool /* is_incognito */, std::vector<Rule>> brave_cookie_rules_;
 
   bool initialized_;
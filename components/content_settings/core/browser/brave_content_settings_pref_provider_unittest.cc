@@ -4,15 +4,22 @@
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include "base/macros.h"
 #include "base/optional.h"
+#include "base/run_loop.h"
+#include "base/stl_util.h"
 #include "brave/common/pref_names.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/components/content_settings/core/browser/brave_content_settings_pref_provider.h"
 #include "chrome/test/base/testing_profile.h"
+#include "components/content_settings/core/browser/content_settings_observer.h"
 #include "components/content_settings/core/browser/content_settings_registry.h"
+#include "components/content_settings/core/browser/content_settings_rule.h"
 #include "components/content_settings/core/common/content_settings.h"
 #include "components/content_settings/core/common/content_settings_pattern.h"
 #include "components/content_settings/core/common/content_settings_utils.h"
@@ -28,6 +35,9 @@ namespace content_settings {
 namespace {
 
 using GURLSourcePair = std::pair<GURL, const char*>;
+using CookieRule =
+    std::tuple<ContentSettingsPattern, ContentSettingsPattern, ContentSetting>;
+using PatternPair = std::pair<ContentSettingsPattern, ContentSettingsPattern>;
 
 ContentSettingsPattern SecondaryUrlToPattern(const GURL& gurl) {
   CHECK(gurl == GURL() || gurl == GURL("https://firstParty/*"));
@@ -145,6 +155,83 @@ class ShieldsScriptSetting : public ShieldsSetting {
   }
 };
 
+void SetShieldsEnabled(BravePrefProvider* provider,
+                       const std::string& pattern,
+                       bool enabled) {
+  provider->SetWebsiteSetting(
+      ContentSettingsPattern::FromString(pattern),
+      ContentSettingsPattern::Wildcard(), ContentSettingsType::PLUGINS,
+      brave_shields::kBraveShields,
+      ContentSettingToValue(enabled ? CONTENT_SETTING_ALLOW
+                                    : CONTENT_SETTING_BLOCK),
+      {});
+}
+
+void SetBraveCookies(BravePrefProvider* provider,
+                     const std::string& pattern,
+                     ContentSetting setting) {
+  provider->SetWebsiteSetting(
+      ContentSettingsPattern::FromString(pattern),
+      ContentSettingsPattern::Wildcard(), ContentSettingsType::PLUGINS,
+      brave_shields::kCookies, ContentSettingToValue(setting), {});
+}
+
+// Brave cookie rules are published with their patterns swapped, see CloneRule.
+CookieRule BraveCookieRule(const std::string& pattern,
+                           ContentSetting setting) {
+  return CookieRule(ContentSettingsPattern::Wildcard(),
+                    ContentSettingsPattern::FromString(pattern), setting);
+}
+
+PatternPair BraveCookiePatterns(const std::string& pattern) {
+  return PatternPair(ContentSettingsPattern::Wildcard(),
+                     ContentSettingsPattern::FromString(pattern));
+}
+
+std::vector<CookieRule> GetCookieRules(RuleIterator* iterator) {
+  std::vector<CookieRule> rules;
+  while (iterator && iterator->HasNext()) {
+    const Rule rule = iterator->Next();
+    rules.emplace_back(rule.primary_pattern, rule.secondary_pattern,
+                       ValueToContentSetting(&rule.value));
+  }
+  return rules;
+}
+
+std::vector<CookieRule> GetCookieRules(const BravePrefProvider& provider) {
+  auto iterator = provider.GetRuleIterator(ContentSettingsType::COOKIES, "",
+                                           false /* incognito */);
+  return GetCookieRules(iterator.get());
+}
+
+// Records the patterns of cookie changes notified by the provider.
+class CookieChangeObserver : public Observer {
+ public:
+  CookieChangeObserver() = default;
+  ~CookieChangeObserver() override = default;
+
+  void OnContentSettingChanged(
+      const ContentSettingsPattern& primary_pattern,
+      const ContentSettingsPattern& secondary_pattern,
+      ContentSettingsType content_type,
+      const std::string& resource_identifier) override {
+    if (content_type == ContentSettingsType::COOKIES)
+      changes_.emplace_back(primary_pattern, secondary_pattern);
+  }
+
+  // Returns the changes notified since the last call.
+  std::vector<PatternPair> TakeChanges() {
+    // Brave cookie changes are notified asynchronously.
+    base::RunLoop().RunUntilIdle();
+    return std::move(changes_);
+  }
+
+ private:
+  std::vector<PatternPair> changes_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieChangeObserver);
+};
+
 }  // namespace
 
 class BravePrefProviderTest : public testing::Test {
@@ -337,4 +424,154 @@ TEST_F(BravePrefProviderTest, TestShieldsSettingsMigrationVersion) {
   provider.ShutdownOnUIThread();
 }
 
+TEST_F(BravePrefProviderTest, ShieldsDownOnParentDomainDisablesCookieRules) {
+  BravePrefProvider provider(
+      testing_profile()->GetPrefs(), false /* incognito */,
+      true /* store_last_modified */, false /* restore_session */);
+
+  SetBraveCookies(&provider, "sub.brave.com", CONTENT_SETTING_BLOCK);
+  SetBraveCookies(&provider, "brave.com", CONTENT_SETTING_BLOCK);
+  SetBraveCookies(&provider, "notbrave.com", CONTENT_SETTING_BLOCK);
+  SetShieldsEnabled(&provider, "[*.]sub.brave.com", false);
+
+  auto rules = GetCookieRules(provider);
+  // A shield rule covers its own host and subdomains ...
+  EXPECT_FALSE(base::Contains(
+      rules, BraveCookieRule("sub.brave.com", CONTENT_SETTING_BLOCK)));
+  // ... but not its parent domains.
+  EXPECT_TRUE(base::Contains(
+      rules, BraveCookieRule("brave.com", CONTENT_SETTING_BLOCK)));
+  EXPECT_TRUE(base::Contains(
+      rules, BraveCookieRule("[*.]sub.brave.com", CONTENT_SETTING_ALLOW)));
+
+  SetShieldsEnabled(&provider, "[*.]brave.com", false);
+
+  rules = GetCookieRules(provider);
+  EXPECT_FALSE(base::Contains(
+      rules, BraveCookieRule("brave.com", CONTENT_SETTING_BLOCK)));
+  // Sharing a suffix without a dot is not a subdomain.
+  EXPECT_TRUE(base::Contains(
+      rules, BraveCookieRule("notbrave.com", CONTENT_SETTING_BLOCK)));
+
+  provider.ShutdownOnUIThread();
+}
+
+TEST_F(BravePrefProviderTest, ShieldsDownWithWildcardsDisablesCookieRules) {
+  BravePrefProvider provider(
+      testing_profile()->GetPrefs(), false /* incognito */,
+      true /* store_last_modified */, false /* restore_session */);
+
+  SetBraveCookies(&provider, "https://brave.com", CONTENT_SETTING_BLOCK);
+  SetBraveCookies(&provider, "http://brave.com:8080", CONTENT_SETTING_BLOCK);
+  SetBraveCookies(&provider, "https://brave2.com", CONTENT_SETTING_BLOCK);
+  // Matches brave.com with any scheme and port.
+  SetShieldsEnabled(&provider, "brave.com", false);
+
+  const auto rules = GetCookieRules(provider);
+  EXPECT_FALSE(base::Contains(
+      rules, BraveCookieRule("https://brave.com", CONTENT_SETTING_BLOCK)));
+  EXPECT_FALSE(base::Contains(
+      rules, BraveCookieRule("http://brave.com:8080", CONTENT_SETTING_BLOCK)));
+  EXPECT_TRUE(base::Contains(
+      rules, BraveCookieRule("https://brave2.com", CONTENT_SETTING_BLOCK)));
+
+  provider.ShutdownOnUIThread();
+}
+
+TEST_F(BravePrefProviderTest, FirstCoveringShieldRuleWins) {
+  BravePrefProvider provider(
+      testing_profile()->GetPrefs(), false /* incognito */,
+      true /* store_last_modified */, false /* restore_session */);
+
+  SetBraveCookies(&provider, "a.sub.brave.com", CONTENT_SETTING_BLOCK);
+  SetBraveCookies(&provider, "other.brave.com", CONTENT_SETTING_BLOCK);
+
+  // Both shield rules cover a.sub.brave.com, the more specific one comes first.
+  SetShieldsEnabled(&provider, "[*.]sub.brave.com", true);
+  SetShieldsEnabled(&provider, "[*.]brave.com", false);
+
+  auto rules = GetCookieRules(provider);
+  EXPECT_TRUE(base::Contains(
+      rules, BraveCookieRule("a.sub.brave.com", CONTENT_SETTING_BLOCK)));
+  EXPECT_FALSE(base::Contains(
+      rules, BraveCookieRule("other.brave.com", CONTENT_SETTING_BLOCK)));
+
+  SetShieldsEnabled(&provider, "[*.]sub.brave.com", false);
+  SetShieldsEnabled(&provider, "[*.]brave.com", true);
+
+  rules = GetCookieRules(provider);
+  EXPECT_FALSE(base::Contains(
+      rules, BraveCookieRule("a.sub.brave.com", CONTENT_SETTING_BLOCK)));
+  EXPECT_TRUE(base::Contains(
+      rules, BraveCookieRule("other.brave.com", CONTENT_SETTING_BLOCK)));
+
+  provider.ShutdownOnUIThread();
+}
+
+TEST_F(BravePrefProviderTest, NotifiesAddedChangedAndRemovedCookieRules) {
+  BravePrefProvider provider(
+      testing_profile()->GetPrefs(), false /* incognito */,
+      true /* store_last_modified */, false /* restore_session */);
+  CookieChangeObserver observer;
+  provider.AddObserver(&observer);
+
+  // Added.
+  SetBraveCookies(&provider, "unchanged.com", CONTENT_SETTING_BLOCK);
+  SetBraveCookies(&provider, "brave.com", CONTENT_SETTING_BLOCK);
+  EXPECT_EQ(std::vector<PatternPair>({BraveCookiePatterns("unchanged.com"),
+                                      BraveCookiePatterns("brave.com")}),
+            observer.TakeChanges());
+
+  // Changed.
+  SetBraveCookies(&provider, "brave.com", CONTENT_SETTING_ALLOW);
+  EXPECT_EQ(std::vector<PatternPair>({BraveCookiePatterns("brave.com")}),
+            observer.TakeChanges());
+  EXPECT_TRUE(base::Contains(
+      GetCookieRules(provider),
+      BraveCookieRule("brave.com", CONTENT_SETTING_ALLOW)));
+
+  // Removed.
+  SetBraveCookies(&provider, "brave.com", CONTENT_SETTING_DEFAULT);
+  EXPECT_EQ(std::vector<PatternPair>({BraveCookiePatterns("brave.com")}),
+            observer.TakeChanges());
+  EXPECT_FALSE(base::Contains(
+      GetCookieRules(provider),
+      BraveCookieRule("brave.com", CONTENT_SETTING_ALLOW)));
+  EXPECT_TRUE(base::Contains(
+      GetCookieRules(provider),
+      BraveCookieRule("unchanged.com", CONTENT_SETTING_BLOCK)));
+
+  provider.RemoveObserver(&observer);
+  provider.ShutdownOnUIThread();
+}
+
+TEST_F(BravePrefProviderTest, CookieRuleIteratorOutlivesRebuild) {
+  BravePrefProvider provider(
+      testing_profile()->GetPrefs(), false /* incognito */,
+      true /* store_last_modified */, false /* restore_session */);
+
+  SetBraveCookies(&provider, "brave.com", CONTENT_SETTING_BLOCK);
+  auto iterator = provider.GetRuleIterator(ContentSettingsType::COOKIES, "",
+                                           false /* incognito */);
+
+  SetBraveCookies(&provider, "brave.com", CONTENT_SETTING_DEFAULT);
+  SetBraveCookies(&provider, "brave2.com", CONTENT_SETTING_BLOCK);
+
+  // The iterator keeps returning the rules it was created with.
+  const auto old_rules = GetCookieRules(iterator.get());
+  EXPECT_TRUE(base::Contains(
+      old_rules, BraveCookieRule("brave.com", CONTENT_SETTING_BLOCK)));
+  EXPECT_FALSE(base::Contains(
+      old_rules, BraveCookieRule("brave2.com", CONTENT_SETTING_BLOCK)));
+  iterator.reset();
+
+  const auto new_rules = GetCookieRules(provider);
+  EXPECT_FALSE(base::Contains(
+      new_rules, BraveCookieRule("brave.com", CONTENT_SETTING_BLOCK)));
+  EXPECT_TRUE(base::Contains(
+      new_rules, BraveCookieRule("brave2.com", CONTENT_SETTING_BLOCK)));
+
+  provider.ShutdownOnUIThread();
+}
+
 }  //  namespace content_settings
@@ -31,6 +31,7 @@
 #include "brave/components/brave_component_updater/browser/switches.h"
 #include "brave/components/greaselion/browser/greaselion_download_service.h"
 #include "chrome/browser/extensions/extension_service.h"
+#include "crypto/secure_hash.h"
 #include "crypto/sha2.h"
 #include "extensions/browser/extension_registry.h"
 #include "extensions/browser/extension_system.h"
@@ -53,7 +54,7 @@ namespace {
 // NOTE: The caller takes ownership of the directory at extension->path() on the
 // returned object.
 scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
-    greaselion::GreaselionRule* rule,
+    const greaselion::GreaselionRuleSnapshot& rule,
     const base::FilePath& extensions_dir) {
   base::FilePath install_temp_dir =
       extensions::file_util::GetInstallTempDir(extensions_dir);
@@ -82,7 +83,7 @@ scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
   // public key.
   char raw[crypto::kSHA256Length] = {0};
   std::string key;
-  std::string script_name = rule->name();
+  std::string script_name = rule.name;
   const base::CommandLine& command_line =
       *base::CommandLine::ForCurrentProcess();
   if (!command_line.HasSwitch(brave_component_updater::kUseGoUpdateDev) &&
@@ -104,11 +105,11 @@ scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
   root->SetStringPath(extensions::manifest_keys::kPublicKey, key);
 
   auto js_files = std::make_unique<base::ListValue>();
-  for (auto script : rule->scripts())
+  for (const auto& script : rule.scripts)
     js_files->AppendString(script.BaseName().value());
 
   auto matches = std::make_unique<base::ListValue>();
-  for (auto url_pattern : rule->url_patterns())
+  for (const auto& url_pattern : rule.url_patterns)
     matches->AppendString(url_pattern);
 
   auto content_script = std::make_unique<base::DictionaryValue>();
@@ -116,7 +117,7 @@ scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
   content_script->Set(extensions::manifest_keys::kJs, std::move(js_files));
   // All Greaselion scripts default to document end.
   content_script->SetStringPath(extensions::manifest_keys::kRunAt,
-      rule->run_at() == extensions::manifest_values::kRunAtDocumentStart
+      rule.run_at == extensions::manifest_values::kRunAtDocumentStart
         ? extensions::manifest_values::kRunAtDocumentStart
         : extensions::manifest_values::kRunAtDocumentEnd);
 
@@ -140,7 +141,7 @@ scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
   }
 
   // Copy the script files to our extension directory.
-  for (auto script : rule->scripts()) {
+  for (const auto& script : rule.scripts) {
     if (!base::CopyFile(script, temp_dir.GetPath().Append(script.BaseName()))) {
       LOG(ERROR) << "Could not copy Greaselion script at path: "
           << script.LossyDisplayName();
@@ -160,10 +161,78 @@ scoped_refptr<Extension> ConvertGreaselionRuleToExtensionOnTaskRunner(
   temp_dir.Take();  // The caller takes ownership of the directory.
   return extension;
 }
+
+// Sets each rule's fingerprint to a digest of everything that goes into the
+// extension generated for it (name, run_at, match patterns, script names and
+// contents), or to an empty string if its scripts can't be read.
+//
+// NOTE: This function does file IO and should not be called on the UI thread.
+std::vector<greaselion::GreaselionRuleSnapshot>
+GetRuleFingerprintsOnTaskRunner(
+    std::vector<greaselion::GreaselionRuleSnapshot> rules) {
+  for (auto& rule : rules) {
+    std::unique_ptr<crypto::SecureHash> hash =
+        crypto::SecureHash::Create(crypto::SecureHash::SHA256);
+    // Length-prefix every field so that field boundaries are unambiguous.
+    auto add_size = [&hash](uint64_t size) {
+      hash->Update(&size, sizeof(size));
+    };
+    auto add_string = [&hash, &add_size](const std::string& value) {
+      add_size(value.size());
+      hash->Update(value.data(), value.size());
+    };
+
+    add_string(rule.name);
+    add_string(rule.run_at);
+    add_size(rule.url_patterns.size());
+    for (const auto& url_pattern : rule.url_patterns)
+      add_string(url_pattern);
+
+    add_size(rule.scripts.size());
+    bool scripts_read = true;
+    for (const auto& script : rule.scripts) {
+      std::string contents;
+      if (!base::ReadFileToString(script, &contents)) {
+        scripts_read = false;
+        break;
+      }
+      add_string(script.BaseName().AsUTF8Unsafe());
+      add_string(contents);
+    }
+
+    rule.fingerprint.clear();
+    if (scripts_read) {
+      rule.fingerprint.resize(hash->GetHashLength());
+      hash->Finish(&rule.fingerprint[0], rule.fingerprint.size());
+    }
+  }
+  return rules;
+}
+
 }  // namespace
 
 namespace greaselion {
 
+GreaselionRuleSnapshot::GreaselionRuleSnapshot(const GreaselionRule& rule)
+    : name(rule.name()),
+      run_at(rule.run_at()),
+      url_patterns(rule.url_patterns()),
+      scripts(rule.scripts()) {}
+
+GreaselionRuleSnapshot::GreaselionRuleSnapshot(
+    const GreaselionRuleSnapshot& other) = default;
+
+GreaselionRuleSnapshot::GreaselionRuleSnapshot(
+    GreaselionRuleSnapshot&& other) = default;
+
+GreaselionRuleSnapshot& GreaselionRuleSnapshot::operator=(
+    const GreaselionRuleSnapshot& other) = default;
+
+GreaselionRuleSnapshot& GreaselionRuleSnapshot::operator=(
+    GreaselionRuleSnapshot&& other) = default;
+
+GreaselionRuleSnapshot::~GreaselionRuleSnapshot() = default;
+
 GreaselionServiceImpl::GreaselionServiceImpl(
     GreaselionDownloadService* download_service,
     const base::FilePath& install_directory,
@@ -177,6 +246,7 @@ GreaselionServiceImpl::GreaselionServiceImpl(
       extension_registry_(extension_registry),
       all_rules_installed_successfully_(true),
       update_in_progress_(false),
+      update_requested_(false),
       pending_installs_(0),
       task_runner_(std::move(task_runner)),
       weak_factory_(this) {
@@ -190,66 +260,102 @@ GreaselionServiceImpl::~GreaselionServiceImpl() {
 }
 
 bool GreaselionServiceImpl::IsGreaselionExtension(const std::string& id) {
-  return std::find(greaselion_extensions_.begin(), greaselion_extensions_.end(),
-                   id) != greaselion_extensions_.end();
+  return greaselion_extensions_.count(id) != 0;
 }
 
 void GreaselionServiceImpl::UpdateInstalledExtensions() {
-  if (update_in_progress_)
+  if (update_in_progress_) {
+    // Picked up again by MaybeNotifyObservers() once this update finishes.
+    update_requested_ = true;
     return;
+  }
   update_in_progress_ = true;
-  if (greaselion_extensions_.empty()) {
-    // No Greaselion extensions are currently installed, so we can move on to
-    // the install phase immediately.
+  update_requested_ = false;
+
+  std::vector<GreaselionRuleSnapshot> rules;
+  for (const std::unique_ptr<GreaselionRule>& rule :
+       *download_service_->rules()) {
+    if (rule->Matches(state_) && rule->has_unknown_preconditions() == false)
+      rules.emplace_back(*rule);
+  }
+
+  // Fingerprinting reads the scripts, so it runs on the extension file task
+  // runner, which was passed in in the constructor.
+  base::PostTaskAndReplyWithResult(
+      task_runner_.get(), FROM_HERE,
+      base::BindOnce(&GetRuleFingerprintsOnTaskRunner, std::move(rules)),
+      base::BindOnce(&GreaselionServiceImpl::OnGotRuleFingerprints,
+                     weak_factory_.GetWeakPtr()));
+}
+
+void GreaselionServiceImpl::OnGotRuleFingerprints(
+    std::vector<GreaselionRuleSnapshot> rules) {
+  DCHECK(update_in_progress_);
+
+  // Extensions whose rule is unchanged stay loaded; everything else is
+  // unloaded and (re)generated.
+  std::set<std::string> installed_fingerprints;
+  for (const auto& extension : greaselion_extensions_)
+    installed_fingerprints.insert(extension.second);
+  std::set<std::string> wanted_fingerprints;
+  rules_to_install_.clear();
+  for (auto& rule : rules) {
+    if (!rule.fingerprint.empty()) {
+      if (!wanted_fingerprints.insert(rule.fingerprint).second)
+        continue;
+      if (installed_fingerprints.count(rule.fingerprint))
+        continue;
+    }
+    rules_to_install_.push_back(std::move(rule));
+  }
+
+  pending_unloads_.clear();
+  for (const auto& extension : greaselion_extensions_) {
+    if (!wanted_fingerprints.count(extension.second))
+      pending_unloads_.insert(extension.first);
+  }
+  if (pending_unloads_.empty()) {
     CreateAndInstallExtensions();
     return;
   }
 
-  // Make a copy of greaselion_extensions_ to iterate while the original vector
-  // changes.
-  std::vector<extensions::ExtensionId> extensions = greaselion_extensions_;
-  for (auto id : extensions) {
-    // We need to unload all the Greaselion extensions that are already
-    // installed. OnExtensionUnloaded will be called on each extension, where we
-    // will update the greaselion_extensions_ set. Once it's empty, that
-    // callback will call CreateAndInstallExtensions().
+  // Make a copy of pending_unloads_ to iterate while the original set changes.
+  // OnExtensionUnloaded will be called on each extension, where we will update
+  // pending_unloads_. Once it's empty, that callback will call
+  // CreateAndInstallExtensions().
+  const std::set<extensions::ExtensionId> extensions = pending_unloads_;
+  for (const auto& id : extensions) {
     extension_service_->UnloadExtension(
         id, extensions::UnloadedExtensionReason::UPDATE);
   }
 }
 
 void GreaselionServiceImpl::CreateAndInstallExtensions() {
-  DCHECK(greaselion_extensions_.empty());
+  DCHECK(pending_unloads_.empty());
   DCHECK(update_in_progress_);
   all_rules_installed_successfully_ = true;
-  pending_installs_ = 0;
-  std::vector<std::unique_ptr<GreaselionRule>>* rules =
-      download_service_->rules();
-  for (const std::unique_ptr<GreaselionRule>& rule : *rules) {
-    if (rule->Matches(state_) && rule->has_unknown_preconditions() == false) {
-      pending_installs_ += 1;
-    }
-  }
+  pending_installs_ = static_cast<int>(rules_to_install_.size());
   if (!pending_installs_) {
-    // no rules match, nothing else to do
+    // every matching rule is already installed, nothing else to do
     MaybeNotifyObservers();
     return;
   }
-  for (const std::unique_ptr<GreaselionRule>& rule : *rules) {
-    if (rule->Matches(state_) && rule->has_unknown_preconditions() == false) {
-      // Convert script file to component extension. This must run on extension
-      // file task runner, which was passed in in the constructor.
-      base::PostTaskAndReplyWithResult(
-          task_runner_.get(), FROM_HERE,
-          base::BindOnce(&ConvertGreaselionRuleToExtensionOnTaskRunner,
-                         rule.get(), install_directory_),
-          base::BindOnce(&GreaselionServiceImpl::PostConvert,
-                         weak_factory_.GetWeakPtr()));
-    }
+  std::vector<GreaselionRuleSnapshot> rules;
+  rules.swap(rules_to_install_);
+  for (const auto& rule : rules) {
+    // Convert script file to component extension. This must run on extension
+    // file task runner, which was passed in in the constructor.
+    base::PostTaskAndReplyWithResult(
+        task_runner_.get(), FROM_HERE,
+        base::BindOnce(&ConvertGreaselionRuleToExtensionOnTaskRunner, rule,
+                       install_directory_),
+        base::BindOnce(&GreaselionServiceImpl::PostConvert,
+                       weak_factory_.GetWeakPtr(), rule.fingerprint));
   }
 }
 
 void GreaselionServiceImpl::PostConvert(
+    const std::string& fingerprint,
     scoped_refptr<extensions::Extension> extension) {
   if (!extension.get()) {
     all_rules_installed_successfully_ = false;
@@ -257,7 +363,7 @@ void GreaselionServiceImpl::PostConvert(
     MaybeNotifyObservers();
     LOG(ERROR) << "Could not load Greaselion script";
   } else {
-    greaselion_extensions_.push_back(extension->id());
+    greaselion_extensions_[extension->id()] = fingerprint;
     extension_system_->ready().Post(
         FROM_HERE,
         base::BindOnce(&GreaselionServiceImpl::Install,
@@ -273,9 +379,7 @@ void GreaselionServiceImpl::Install(
 void GreaselionServiceImpl::OnExtensionReady(
     content::BrowserContext* browser_context,
     const extensions::Extension* extension) {
-  auto index = std::find(greaselion_extensions_.begin(),
-                         greaselion_extensions_.end(), extension->id());
-  if (index == greaselion_extensions_.end()) {
+  if (!IsGreaselionExtension(extension->id())) {
     // not one of ours
     return;
   }
@@ -288,14 +392,14 @@ void GreaselionServiceImpl::OnExtensionUnloaded(
     content::BrowserContext* browser_context,
     const extensions::Extension* extension,
     extensions::UnloadedExtensionReason reason) {
-  auto index = std::find(greaselion_extensions_.begin(),
-                         greaselion_extensions_.end(), extension->id());
+  auto index = greaselion_extensions_.find(extension->id());
   if (index == greaselion_extensions_.end()) {
     // not one of ours
     return;
   }
   greaselion_extensions_.erase(index);
-  if (update_in_progress_ && greaselion_extensions_.empty()) {
+  if (update_in_progress_ && pending_unloads_.erase(extension->id()) &&
+      pending_unloads_.empty()) {
     // It's time!
     CreateAndInstallExtensions();
   }
@@ -312,6 +416,12 @@ void GreaselionServiceImpl::RemoveObserver(Observer* observer) {
 void GreaselionServiceImpl::MaybeNotifyObservers() {
   if (!pending_installs_) {
     update_in_progress_ = false;
+    if (update_requested_) {
+      // The rules or features changed while this update ran, so it may have
+      // installed stale extensions. Observers hear about the next one.
+      UpdateInstalledExtensions();
+      return;
+    }
     for (Observer& observer : observers_)
       observer.OnExtensionsReady(this, all_rules_installed_successfully_);
   }
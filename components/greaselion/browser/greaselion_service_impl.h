@@ -7,6 +7,7 @@
 #define BRAVE_COMPONENTS_GREASELION_BROWSER_GREASELION_SERVICE_IMPL_H_
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -31,6 +32,27 @@ class ExtensionSystem;
 namespace greaselion {
 
 class GreaselionDownloadService;
+class GreaselionRule;
+
+// Everything an extension is generated from, copied out of a GreaselionRule.
+// Work on the file task runner uses these copies, since the download service
+// replaces its rules whenever a new configuration arrives.
+struct GreaselionRuleSnapshot {
+  explicit GreaselionRuleSnapshot(const GreaselionRule& rule);
+  GreaselionRuleSnapshot(const GreaselionRuleSnapshot& other);
+  GreaselionRuleSnapshot(GreaselionRuleSnapshot&& other);
+  GreaselionRuleSnapshot& operator=(const GreaselionRuleSnapshot& other);
+  GreaselionRuleSnapshot& operator=(GreaselionRuleSnapshot&& other);
+  ~GreaselionRuleSnapshot();
+
+  std::string name;
+  std::string run_at;
+  std::vector<std::string> url_patterns;
+  std::vector<base::FilePath> scripts;
+  // Digest of the fields above and the script contents. Empty until computed,
+  // or if the scripts can't be read.
+  std::string fingerprint;
+};
 
 class GreaselionServiceImpl : public GreaselionService {
  public:
@@ -58,8 +80,10 @@ class GreaselionServiceImpl : public GreaselionService {
                            extensions::UnloadedExtensionReason reason) override;
 
  private:
+  void OnGotRuleFingerprints(std::vector<GreaselionRuleSnapshot> rules);
   void CreateAndInstallExtensions();
-  void PostConvert(scoped_refptr<extensions::Extension> extension);
+  void PostConvert(const std::string& fingerprint,
+                   scoped_refptr<extensions::Extension> extension);
   void Install(scoped_refptr<extensions::Extension> extension);
   void MaybeNotifyObservers();
 
@@ -71,10 +95,19 @@ class GreaselionServiceImpl : public GreaselionService {
   extensions::ExtensionRegistry* extension_registry_;  // NOT OWNED
   bool all_rules_installed_successfully_;
   bool update_in_progress_;
+  // Set when the rules or features change during an update, so that the
+  // update runs again once the current one finishes.
+  bool update_requested_;
   int pending_installs_;
   scoped_refptr<base::SequencedTaskRunner> task_runner_;
   base::ObserverList<Observer> observers_;
-  std::vector<extensions::ExtensionId> greaselion_extensions_;
+  // Installed Greaselion extensions, mapped to the fingerprint of the rule
+  // they were generated from.
+  std::map<extensions::ExtensionId, std::string> greaselion_extensions_;
+  // Extensions being unloaded because their rule changed or no longer applies.
+  std::set<extensions::ExtensionId> pending_unloads_;
+  // Rules that need a new extension.
+  std::vector<GreaselionRuleSnapshot> rules_to_install_;
   base::WeakPtrFactory<GreaselionServiceImpl> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(GreaselionServiceImpl);
@@ -10,8 +10,6 @@
 
 #include "base/bind.h"
 #include "base/files/file_util.h"
-#include "base/files/file_path.h"
-#include "base/memory/ref_counted_memory.h"
 #include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "brave/components/ntp_background_images/browser/ntp_background_images_data.h"
@@ -24,6 +22,10 @@ namespace ntp_background_images {
 
 namespace {
 
+// Upper bound for the images kept in memory. Large enough for a campaign's
+// wallpapers and logo.
+constexpr size_t kMaxImageCacheSize = 20 * 1024 * 1024;
+
 base::Optional<std::string> ReadFileToString(const base::FilePath& path) {
   std::string contents;
   if (!base::ReadFileToString(path, &contents))
@@ -40,10 +42,16 @@ bool IsSuperReferralPath(const std::string& path) {
 NTPBackgroundImagesSource::NTPBackgroundImagesSource(
     NTPBackgroundImagesService* service)
     : service_(service),
+      image_cache_(decltype(image_cache_)::NO_AUTO_EVICT),
       weak_factory_(this) {
+  if (service_)
+    service_->AddObserver(this);
 }
 
-NTPBackgroundImagesSource::~NTPBackgroundImagesSource() = default;
+NTPBackgroundImagesSource::~NTPBackgroundImagesSource() {
+  if (service_)
+    service_->RemoveObserver(this);
+}
 
 std::string NTPBackgroundImagesSource::GetSource() {
   return kBrandedWallpaperHost;
@@ -92,26 +100,74 @@ void NTPBackgroundImagesSource::StartDataRequest(
 void NTPBackgroundImagesSource::GetImageFile(
     const base::FilePath& image_file_path,
     GotDataCallback callback) {
+  auto cached_image = image_cache_.Get(image_file_path);
+  if (cached_image != image_cache_.end()) {
+    std::move(callback).Run(cached_image->second);
+    return;
+  }
+
   base::PostTaskAndReplyWithResult(
       FROM_HERE, {base::ThreadPool(), base::MayBlock()},
       base::BindOnce(&ReadFileToString, image_file_path),
       base::BindOnce(&NTPBackgroundImagesSource::OnGotImageFile,
                      weak_factory_.GetWeakPtr(),
+                     image_file_path,
+                     image_cache_generation_,
                      std::move(callback)));
 }
 
 void NTPBackgroundImagesSource::OnGotImageFile(
+    const base::FilePath& image_file_path,
+    int cache_generation,
     GotDataCallback callback,
     base::Optional<std::string> input) {
   if (!input)
     return;
 
-  scoped_refptr<base::RefCountedMemory> bytes;
-  bytes = new base::RefCountedBytes(
-       reinterpret_cast<const unsigned char*>(input->c_str()), input->length());
+  scoped_refptr<base::RefCountedMemory> bytes =
+      base::RefCountedString::TakeString(&input.value());
+  if (cache_generation == image_cache_generation_)
+    CacheImage(image_file_path, bytes);
   std::move(callback).Run(std::move(bytes));
 }
 
+void NTPBackgroundImagesSource::CacheImage(
+    const base::FilePath& image_file_path,
+    scoped_refptr<base::RefCountedMemory> image) {
+  if (image->size() > kMaxImageCacheSize)
+    return;
+
+  auto existing = image_cache_.Peek(image_file_path);
+  if (existing != image_cache_.end()) {
+    image_cache_size_ -= existing->second->size();
+    image_cache_.Erase(existing);
+  }
+
+  image_cache_size_ += image->size();
+  image_cache_.Put(image_file_path, std::move(image));
+  while (image_cache_size_ > kMaxImageCacheSize) {
+    auto oldest = image_cache_.rbegin();
+    image_cache_size_ -= oldest->second->size();
+    image_cache_.Erase(oldest);
+  }
+}
+
+void NTPBackgroundImagesSource::ClearImageCache() {
+  image_cache_.Clear();
+  image_cache_size_ = 0;
+  image_cache_generation_++;
+}
+
+void NTPBackgroundImagesSource::OnUpdated(NTPBackgroundImagesData* data) {
+  // Super referral images are copied to a fixed cache directory, so the same
+  // path can refer to new content after an update.
+  ClearImageCache();
+}
+
+void NTPBackgroundImagesSource::OnSuperReferralEnded() {
+  ClearImageCache();
+}
+
 std::string NTPBackgroundImagesSource::GetMimeType(const std::string& path) {
   if (IsLogoPath(path) || IsTopSiteFaviconPath(path))
     return "image/png";
@@ -119,6 +175,8 @@ std::string NTPBackgroundImagesSource::GetMimeType(const std::string& path) {
 }
 
 bool NTPBackgroundImagesSource::AllowCaching() {
+  // Image urls are stable across component updates and data sources can't
+  // send validators, so rely on |image_cache_| instead of the HTTP cache.
   return false;
 }
 
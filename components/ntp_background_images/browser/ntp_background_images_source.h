@@ -8,20 +8,20 @@
 
 #include <string>
 
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/weak_ptr.h"
 #include "base/optional.h"
+#include "brave/components/ntp_background_images/browser/ntp_background_images_service.h"
 #include "content/public/browser/url_data_source.h"
 
-namespace base {
-class FilePath;
-}  // namespace base
-
 namespace ntp_background_images {
 
-class NTPBackgroundImagesService;
-
-// This serves background image data.
-class NTPBackgroundImagesSource : public content::URLDataSource {
+// This serves background image data. Recently served images are kept in
+// memory until the images component is updated.
+class NTPBackgroundImagesSource : public content::URLDataSource,
+                                  public NTPBackgroundImagesService::Observer {
  public:
   explicit NTPBackgroundImagesSource(NTPBackgroundImagesService* service);
 
@@ -35,6 +35,7 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest, BasicTest);
   FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest,
                            BasicSuperReferralDataTest);
+  FRIEND_TEST_ALL_PREFIXES(NTPBackgroundImagesSourceTest, ImageCacheTest);
 
   // content::URLDataSource overrides:
   std::string GetSource() override;
@@ -44,10 +45,19 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   std::string GetMimeType(const std::string& path) override;
   bool AllowCaching() override;
 
+  // NTPBackgroundImagesService::Observer overrides:
+  void OnUpdated(NTPBackgroundImagesData* data) override;
+  void OnSuperReferralEnded() override;
+
   void GetImageFile(const base::FilePath& image_file_path,
                     GotDataCallback callback);
-  void OnGotImageFile(GotDataCallback callback,
+  void OnGotImageFile(const base::FilePath& image_file_path,
+                      int cache_generation,
+                      GotDataCallback callback,
                       base::Optional<std::string> input);
+  void CacheImage(const base::FilePath& image_file_path,
+                  scoped_refptr<base::RefCountedMemory> image);
+  void ClearImageCache();
   bool IsValidPath(const std::string& path) const;
   bool IsLogoPath(const std::string& path) const;
   bool IsWallpaperPath(const std::string& path) const;
@@ -56,6 +66,12 @@ class NTPBackgroundImagesSource : public content::URLDataSource {
   base::FilePath GetTopSiteFaviconFilePath(const std::string& path) const;
 
   NTPBackgroundImagesService* service_;  // not owned
+  base::MRUCache<base::FilePath, scoped_refptr<base::RefCountedMemory>>
+      image_cache_;
+  size_t image_cache_size_ = 0;
+  // Bumped on every component update so reads started before the update are
+  // not cached.
+  int image_cache_generation_ = 0;
   base::WeakPtrFactory<NTPBackgroundImagesSource> weak_factory_;
 };
 
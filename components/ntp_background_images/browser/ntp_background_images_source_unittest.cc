@@ -6,6 +6,10 @@
 #include <memory>
 #include <string>
 
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/test/task_environment.h"
 #include "brave/components/brave_referrals/browser/brave_referrals_service.h"
 #include "brave/components/brave_referrals/buildflags/buildflags.h"
@@ -33,7 +37,7 @@ class NTPBackgroundImagesSourceTest : public testing::Test {
                     base::Value(base::Value::Type::DICTIONARY));
   }
 
-  base::test::SingleThreadTaskEnvironment task_environment;
+  base::test::TaskEnvironment task_environment;
   TestingPrefServiceSimple local_pref_;
   std::unique_ptr<NTPBackgroundImagesService> service_;
   std::unique_ptr<NTPBackgroundImagesSource> source_;
@@ -79,6 +83,37 @@ TEST_F(NTPBackgroundImagesSourceTest, BasicTest) {
       source_->GetWallpaperIndexFromPath("sponsored-images/wallpaper-3.jpg"));
 }
 
+TEST_F(NTPBackgroundImagesSourceTest, ImageCacheTest) {
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  const base::FilePath image_path =
+      temp_dir.GetPath().AppendASCII("background-1.jpg");
+  const std::string image_data = "image data";
+  ASSERT_EQ(static_cast<int>(image_data.size()),
+            base::WriteFile(image_path, image_data.data(), image_data.size()));
+
+  std::string served_data;
+  auto callback = [](std::string* served_data,
+                     scoped_refptr<base::RefCountedMemory> bytes) {
+    *served_data = std::string(bytes->front_as<char>(), bytes->size());
+  };
+  source_->GetImageFile(image_path, base::BindOnce(callback, &served_data));
+  task_environment.RunUntilIdle();
+  EXPECT_EQ(image_data, served_data);
+  EXPECT_EQ(image_data.size(), source_->image_cache_size_);
+
+  // Served from memory once cached.
+  ASSERT_TRUE(base::DeleteFile(image_path));
+  served_data.clear();
+  source_->GetImageFile(image_path, base::BindOnce(callback, &served_data));
+  EXPECT_EQ(image_data, served_data);
+
+  // Component update drops cached images.
+  service_->OnGetComponentJsonData(false, "{}");
+  EXPECT_EQ(0u, source_->image_cache_.size());
+  EXPECT_EQ(0u, source_->image_cache_size_);
+}
+
 #if BUILDFLAG(ENABLE_BRAVE_REFERRALS)
 
 #if !defined(OS_LINUX)
@@ -6,10 +6,15 @@
 #include "brave/components/omnibox/browser/topsites_provider.h"
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include <algorithm>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "base/no_destructor.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "brave/common/pref_names.h"
@@ -21,9 +26,86 @@
 // Search Secondary Provider (suggestion)                              |  100++
 const int TopSitesProvider::kRelevance = 100;
 
+namespace {
+
+// A suffix of one of the top sites, identified by its index in the list and
+// the offset the suffix starts at.
+struct SiteSuffix {
+  uint32_t site;
+  uint32_t offset;
+};
+
+base::StringPiece GetSuffix(const std::vector<std::string>& sites,
+                            const SiteSuffix& suffix) {
+  return base::StringPiece(sites[suffix.site]).substr(suffix.offset);
+}
+
+// Builds a suffix array over all sites so that every site containing a given
+// substring can be found with a binary search.
+std::vector<SiteSuffix> BuildSuffixArray(
+    const std::vector<std::string>& sites) {
+  std::vector<SiteSuffix> suffixes;
+  for (size_t site = 0; site < sites.size(); ++site) {
+    for (size_t offset = 0; offset < sites[site].length(); ++offset) {
+      suffixes.push_back(
+          {static_cast<uint32_t>(site), static_cast<uint32_t>(offset)});
+    }
+  }
+  std::sort(suffixes.begin(), suffixes.end(),
+            [&sites](const SiteSuffix& lhs, const SiteSuffix& rhs) {
+              return GetSuffix(sites, lhs) < GetSuffix(sites, rhs);
+            });
+  return suffixes;
+}
+
+// Returns the suffix array for |sites|, which is always the static top sites
+// list. It is built on first use and shared by all providers.
+const std::vector<SiteSuffix>& GetSuffixArray(
+    const std::vector<std::string>& sites) {
+  static const base::NoDestructor<std::vector<SiteSuffix>> suffix_array(
+      BuildSuffixArray(sites));
+  return *suffix_array;
+}
+
+// Returns (site index, position of the first occurrence) for the sites
+// containing |text|, in list order, up to |max_matches| entries.
+std::vector<std::pair<uint32_t, uint32_t>> FindSitesContaining(
+    const std::vector<std::string>& sites,
+    const std::vector<SiteSuffix>& suffix_array,
+    base::StringPiece text,
+    size_t max_matches) {
+  const auto begin = std::lower_bound(
+      suffix_array.begin(), suffix_array.end(), text,
+      [&sites, &text](const SiteSuffix& suffix, base::StringPiece value) {
+        return GetSuffix(sites, suffix).substr(0, text.length()) < value;
+      });
+  const auto end = std::upper_bound(
+      begin, suffix_array.end(), text,
+      [&sites, &text](base::StringPiece value, const SiteSuffix& suffix) {
+        return value < GetSuffix(sites, suffix).substr(0, text.length());
+      });
+
+  std::vector<std::pair<uint32_t, uint32_t>> occurrences;
+  occurrences.reserve(end - begin);
+  for (auto it = begin; it != end; ++it)
+    occurrences.emplace_back(it->site, it->offset);
+  std::sort(occurrences.begin(), occurrences.end());
+
+  std::vector<std::pair<uint32_t, uint32_t>> matches;
+  for (const auto& occurrence : occurrences) {
+    if (matches.size() >= max_matches)
+      break;
+    if (matches.empty() || matches.back().first != occurrence.first)
+      matches.push_back(occurrence);
+  }
+  return matches;
+}
+
+}  // namespace
 
 TopSitesProvider::TopSitesProvider(AutocompleteProviderClient* client)
     : AutocompleteProvider(AutocompleteProvider::TYPE_SEARCH), client_(client) {
+  GetSuffixArray(top_sites_);
 }
 
 void TopSitesProvider::Start(const AutocompleteInput& input,
@@ -42,16 +124,13 @@ void TopSitesProvider::Start(const AutocompleteInput& input,
   const std::string input_text =
       base::ToLowerASCII(base::UTF16ToUTF8(input.text()));
 
-  for (std::vector<std::string>::const_iterator i = top_sites_.begin();
-       (i != top_sites_.end()) && (matches_.size() < provider_max_matches());
-       ++i) {
-    const std::string &current_site = *i;
-    size_t foundPos = current_site.find(input_text);
-    if (std::string::npos != foundPos) {
-      ACMatchClassifications styles =
-          StylesForSingleMatch(input_text, current_site, foundPos);
-      AddMatch(base::ASCIIToUTF16(current_site), styles);
-    }
+  for (const auto& match : FindSitesContaining(
+           top_sites_, GetSuffixArray(top_sites_), input_text,
+           provider_max_matches())) {
+    const std::string& current_site = top_sites_[match.first];
+    ACMatchClassifications styles =
+        StylesForSingleMatch(input_text, current_site, match.second);
+    AddMatch(base::ASCIIToUTF16(current_site), styles);
   }
 
   for (size_t i = 0; i < matches_.size(); ++i) {
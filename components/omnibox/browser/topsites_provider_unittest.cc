@@ -56,3 +56,20 @@ TEST_F(TopSitesProviderTest, NoMatchingWhenPrefIsOff) {
   provider_->Start(CreateAutocompleteInput("dex"), false);
   EXPECT_TRUE(provider_->matches().empty());
 }
+
+// Checks that matches keep the order of the top sites list, wherever the input
+// is found in the site.
+TEST_F(TopSitesProviderTest, MatchesInListOrder) {
+  provider_->Start(CreateAutocompleteInput("mail"), false);
+  const ACMatches& matches = provider_->matches();
+  ASSERT_GE(matches.size(), 2u);
+  EXPECT_EQ(base::ASCIIToUTF16("gmail.com"), matches[0].contents);
+  EXPECT_EQ(base::ASCIIToUTF16("mail.google.com"), matches[1].contents);
+  EXPECT_GT(matches[0].relevance, matches[1].relevance);
+
+  // "gmail.com" matches at position 1, "mail.google.com" at the start.
+  ASSERT_EQ(3u, matches[0].contents_class.size());
+  EXPECT_EQ(1u, matches[0].contents_class[1].offset);
+  ASSERT_EQ(2u, matches[1].contents_class.size());
+  EXPECT_EQ(4u, matches[1].contents_class[1].offset);
+}
@@ -22,6 +22,9 @@ constexpr char kLogValueKey[] = "value";
 constexpr char kLogSentKey[] = "sent";
 constexpr char kLogTimestampKey[] = "timestamp";
 
+// Histograms tend to change in bursts, e.g. on startup.
+constexpr base::TimeDelta kPersistDelay = base::TimeDelta::FromSeconds(1);
+
 void RecordP3A(uint64_t answers_count) {
   int answer = 0;
   if (1 <= answers_count && answers_count < 5) {
@@ -43,7 +46,12 @@ BraveP3ALogStore::BraveP3ALogStore(Delegate* delegate,
   DCHECK(local_state);
 }
 
-BraveP3ALogStore::~BraveP3ALogStore() = default;
+BraveP3ALogStore::~BraveP3ALogStore() {
+  // Write out whatever changed since the last persist, e.g. the sent flag of
+  // an answer uploaded right before shutdown.
+  if (!changed_entries_.empty())
+    PersistChangedEntries();
+}
 
 void BraveP3ALogStore::RegisterPrefs(PrefRegistrySimple* registry) {
   registry->RegisterDictionaryPref(kPrefName);
@@ -58,11 +66,7 @@ void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
     unsent_entries_.insert(histogram_name);
   }
 
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({histogram_name, kLogValueKey},
-                  base::Value(base::NumberToString(value)));
-  update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+  SchedulePersist(histogram_name);
 }
 
 void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
@@ -70,9 +74,7 @@ void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
   log_.erase(histogram_name);
   unsent_entries_.erase(histogram_name);
 
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->RemovePath(histogram_name);
+  SchedulePersist(histogram_name);
 
   if (has_staged_log() && staged_entry_key_ == histogram_name) {
     staged_entry_key_.clear();
@@ -82,18 +84,13 @@ void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
 
 void BraveP3ALogStore::ResetUploadStamps() {
   // Clear log entries flags.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
   for (auto& pair : log_) {
     if (pair.second.sent) {
       DCHECK(!pair.second.sent_timestamp.is_null());
       DCHECK(!unsent_entries_.contains(pair.first));
 
       pair.second.ResetSentState();
-
-      // Update persistent values.
-      update->SetPath({pair.first, kLogSentKey}, base::Value(pair.second.sent));
-      update->SetPath({pair.first, kLogTimestampKey},
-                      base::Value(pair.second.sent_timestamp.ToDoubleT()));
+      SchedulePersist(pair.first);
     }
   }
 
@@ -166,13 +163,7 @@ void BraveP3ALogStore::DiscardStagedLog() {
   auto log_iter = log_.find(staged_entry_key_);
   DCHECK(log_iter != log_.end());
   log_iter->second.MarkAsSent();
-
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({log_iter->first, kLogSentKey},
-                  base::Value(log_iter->second.sent));
-  update->SetPath({log_iter->first, kLogTimestampKey},
-                  base::Value(log_iter->second.sent_timestamp.ToDoubleT()));
+  SchedulePersist(log_iter->first);
 
   // Erase the entry from the unsent queue.
   auto unsent_entries_iter = unsent_entries_.find(staged_entry_key_);
@@ -242,4 +233,31 @@ void BraveP3ALogStore::LoadPersistedUnsentLogs() {
   }
 }
 
+void BraveP3ALogStore::SchedulePersist(const std::string& histogram_name) {
+  changed_entries_.insert(histogram_name);
+  if (!persist_timer_.IsRunning()) {
+    persist_timer_.Start(FROM_HERE, kPersistDelay, this,
+                         &BraveP3ALogStore::PersistChangedEntries);
+  }
+}
+
+void BraveP3ALogStore::PersistChangedEntries() {
+  DictionaryPrefUpdate update(local_state_, kPrefName);
+  for (const std::string& name : changed_entries_) {
+    auto iter = log_.find(name);
+    if (iter == log_.end()) {
+      update->RemovePath(name);
+      continue;
+    }
+
+    const LogEntry& entry = iter->second;
+    update->SetPath({name, kLogValueKey},
+                    base::Value(base::NumberToString(entry.value)));
+    update->SetPath({name, kLogSentKey}, base::Value(entry.sent));
+    update->SetPath({name, kLogTimestampKey},
+                    base::Value(entry.sent_timestamp.ToDoubleT()));
+  }
+  changed_entries_.clear();
+}
+
 }  // namespace brave
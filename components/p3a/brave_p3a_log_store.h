@@ -12,6 +12,7 @@
 #include "base/containers/flat_set.h"
 #include "base/strings/string_piece.h"
 #include "base/time/time.h"
+#include "base/timer/timer.h"
 #include "components/metrics/log_store.h"
 
 class PrefService;
@@ -19,7 +20,8 @@ class PrefRegistrySimple;
 
 namespace brave {
 
-// Stores all given values in memory and persists in prefs on the fly.
+// Stores all given values in memory and persists them in prefs shortly after
+// they change, coalescing bursts of changes into a single pref update.
 // All logs (not only unsent are persistent), and all logs could be loaded
 // using |LoadPersistedUnsentLogs()|. We should fix this at some point since
 // for now persisted entries never expire.
@@ -60,8 +62,8 @@ class BraveP3ALogStore : public metrics::LogStore {
   void DiscardStagedLog() override;
   void MarkStagedLogAsSent() override;
 
-  // |PersistUnsentLogs| should not be used, since we persist everything
-  // on the fly.
+  // |PersistUnsentLogs| should not be used, since changes are persisted
+  // shortly after they happen and on destruction.
   void PersistUnsentLogs() const override;
   // Returns early if founds malformed persisted values.
   void LoadPersistedUnsentLogs() override;
@@ -84,6 +86,11 @@ class BraveP3ALogStore : public metrics::LogStore {
     base::Time sent_timestamp;  // At the moment only for debugging purposes.
   };
 
+  // Marks the entry to be written to (or removed from) prefs on the next
+  // persist.
+  void SchedulePersist(const std::string& histogram_name);
+  void PersistChangedEntries();
+
   const Delegate* const delegate_ = nullptr;  // Weak.
   PrefService* const local_state_ = nullptr;
 
@@ -91,6 +98,9 @@ class BraveP3ALogStore : public metrics::LogStore {
   base::flat_map<std::string, LogEntry> log_;
   base::flat_set<std::string> unsent_entries_;
 
+  base::flat_set<std::string> changed_entries_;
+  base::OneShotTimer persist_timer_;
+
   std::string staged_entry_key_;
   std::string staged_log_;
 
@@ -0,0 +1,103 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_log_store.h"
+
+#include <memory>
+#include <string>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/test/task_environment.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "components/prefs/testing_pref_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=P3ALogStoreTest.*
+
+namespace brave {
+
+namespace {
+
+constexpr char kPrefName[] = "p3a.logs";
+constexpr char kHistogramName[] = "Brave.P3A.Test";
+
+class TestDelegate : public BraveP3ALogStore::Delegate {
+ public:
+  std::string Serialize(base::StringPiece histogram_name,
+                        uint64_t value) const override {
+    return histogram_name.as_string() + base::NumberToString(value);
+  }
+
+  bool IsActualMetric(base::StringPiece histogram_name) const override {
+    return true;
+  }
+};
+
+}  // namespace
+
+class P3ALogStoreTest : public testing::Test {
+ public:
+  P3ALogStoreTest()
+      : task_environment_(base::test::TaskEnvironment::TimeSource::MOCK_TIME) {
+    BraveP3ALogStore::RegisterPrefs(local_state_.registry());
+    log_store_ = std::make_unique<BraveP3ALogStore>(&delegate_, &local_state_);
+  }
+
+  // Returns the persisted entry for |kHistogramName|, or nullptr.
+  const base::Value* GetPersistedEntry() {
+    return local_state_.GetDictionary(kPrefName)->FindDictKey(kHistogramName);
+  }
+
+ protected:
+  base::test::TaskEnvironment task_environment_;
+  TestingPrefServiceSimple local_state_;
+  TestDelegate delegate_;
+  std::unique_ptr<BraveP3ALogStore> log_store_;
+};
+
+TEST_F(P3ALogStoreTest, PersistsAfterDelay) {
+  log_store_->UpdateValue(kHistogramName, 1);
+  log_store_->UpdateValue(kHistogramName, 2);
+  EXPECT_FALSE(GetPersistedEntry());
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(1));
+  const base::Value* entry = GetPersistedEntry();
+  ASSERT_TRUE(entry);
+  EXPECT_EQ("2", *entry->FindStringKey("value"));
+  EXPECT_FALSE(*entry->FindBoolKey("sent"));
+}
+
+TEST_F(P3ALogStoreTest, PersistsOnDestruction) {
+  log_store_->UpdateValue(kHistogramName, 3);
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(1));
+
+  // Upload the answer and shut down before the persist delay elapses.
+  log_store_->StageNextLog();
+  log_store_->DiscardStagedLog();
+  log_store_.reset();
+
+  const base::Value* entry = GetPersistedEntry();
+  ASSERT_TRUE(entry);
+  EXPECT_EQ("3", *entry->FindStringKey("value"));
+  EXPECT_TRUE(*entry->FindBoolKey("sent"));
+
+  // A store loaded after restart must not upload the answer again.
+  log_store_ = std::make_unique<BraveP3ALogStore>(&delegate_, &local_state_);
+  log_store_->LoadPersistedUnsentLogs();
+  EXPECT_FALSE(log_store_->has_unsent_logs());
+}
+
+TEST_F(P3ALogStoreTest, PersistsRemovalOnDestruction) {
+  log_store_->UpdateValue(kHistogramName, 1);
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(1));
+  ASSERT_TRUE(GetPersistedEntry());
+
+  log_store_->RemoveValueIfExists(kHistogramName);
+  log_store_.reset();
+  EXPECT_FALSE(GetPersistedEntry());
+}
+
+}  // namespace brave
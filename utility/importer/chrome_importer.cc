@@ -50,6 +50,12 @@ using base::Time;
 
 namespace {
 
+// History rows and favicons are handed to the bridge in chunks, so the
+// importer never holds all of them and the browser writes each chunk while
+// the next one is read.
+constexpr size_t kHistoryRowsChunkSize = 1000;
+constexpr size_t kFaviconsChunkSize = 100;
+
 // Most of below code is copied from os_crypt_win.cc
 #if defined(OS_WIN)
 // Contains base64 random key encrypted with DPAPI.
@@ -225,6 +231,7 @@ void ChromeImporter::ImportHistory() {
   s.BindInt64(4, ui::PAGE_TRANSITION_KEYWORD_GENERATED);
 
   std::vector<ImporterURLRow> rows;
+  rows.reserve(kHistoryRowsChunkSize);
   while (s.Step() && !cancelled()) {
     GURL url(s.ColumnString(0));
 
@@ -237,6 +244,10 @@ void ChromeImporter::ImportHistory() {
     row.visit_count = s.ColumnInt(4);
 
     rows.push_back(row);
+    if (rows.size() == kHistoryRowsChunkSize) {
+      bridge_->SetHistoryItems(rows, importer::VISIT_SOURCE_CHROME_IMPORTED);
+      rows.clear();
+    }
   }
 
   if (!rows.empty() && !cancelled())
@@ -308,11 +319,8 @@ void ChromeImporter::ImportBookmarks() {
   FaviconMap favicon_map;
   ImportFaviconURLs(&db, &favicon_map);
   // Write favicons into profile.
-  if (!favicon_map.empty() && !cancelled()) {
-    favicon_base::FaviconUsageDataList favicons;
-    LoadFaviconData(&db, favicon_map, &favicons);
-    bridge_->SetFavicons(favicons);
-  }
+  if (!favicon_map.empty() && !cancelled())
+    LoadFaviconData(&db, favicon_map);
 }
 
 void ChromeImporter::ImportFaviconURLs(
@@ -330,8 +338,7 @@ void ChromeImporter::ImportFaviconURLs(
 
 void ChromeImporter::LoadFaviconData(
     sql::Database* db,
-    const FaviconMap& favicon_map,
-    favicon_base::FaviconUsageDataList* favicons) {
+    const FaviconMap& favicon_map) {
   const char query[] = "SELECT f.url, fb.image_data "
                        "FROM favicons f "
                        "JOIN favicon_bitmaps fb "
@@ -342,8 +349,11 @@ void ChromeImporter::LoadFaviconData(
   if (!s.is_valid())
     return;
 
+  favicon_base::FaviconUsageDataList favicons;
+  favicons.reserve(kFaviconsChunkSize);
   for (FaviconMap::const_iterator i = favicon_map.begin();
-       i != favicon_map.end(); ++i) {
+       i != favicon_map.end() && !cancelled(); ++i) {
+    s.Reset(true);
     s.BindInt64(0, i->first);
     if (s.Step()) {
       favicon_base::FaviconUsageData usage;
@@ -361,10 +371,16 @@ void ChromeImporter::LoadFaviconData(
         continue;  // Unable to decode.
 
       usage.urls = i->second;
-      favicons->push_back(usage);
+      favicons.push_back(std::move(usage));
+      if (favicons.size() == kFaviconsChunkSize) {
+        bridge_->SetFavicons(favicons);
+        favicons.clear();
+      }
     }
-    s.Reset(true);
   }
+
+  if (!favicons.empty() && !cancelled())
+    bridge_->SetFavicons(favicons);
 }
 
 void ChromeImporter::RecursiveReadBookmarksFolder(
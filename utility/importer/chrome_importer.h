@@ -62,10 +62,9 @@ class ChromeImporter : public Importer {
     sql::Database* db,
     FaviconMap* favicon_map);
 
-  // Loads and reencodes the individual favicons.
-  void LoadFaviconData(sql::Database* db,
-                       const FaviconMap& favicon_map,
-                       favicon_base::FaviconUsageDataList* favicons);
+  // Loads and reencodes the individual favicons, handing them to the bridge
+  // in chunks.
+  void LoadFaviconData(sql::Database* db, const FaviconMap& favicon_map);
 
   void RecursiveReadBookmarksFolder(
     const base::DictionaryValue* folder,
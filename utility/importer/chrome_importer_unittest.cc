@@ -6,6 +6,7 @@
 #include "brave/utility/importer/chrome_importer.h"
 
 #include <string>
+#include <vector>
 
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
@@ -20,7 +21,10 @@
 #include "chrome/common/importer/mock_importer_bridge.h"
 #include "components/favicon_base/favicon_usage_data.h"
 #include "components/os_crypt/os_crypt_mocker.h"
+#include "sql/database.h"
+#include "sql/statement.h"
 #include "testing/gtest/include/gtest/gtest.h"
+#include "ui/base/page_transition_types.h"
 
 using base::ASCIIToUTF16;
 using base::UTF16ToASCII;
@@ -87,6 +91,51 @@ TEST_F(ChromeImporterTest, ImportHistory) {
   EXPECT_EQ("https://www.nytimes.com/", history[2].url.spec());
 }
 
+TEST_F(ChromeImporterTest, ImportHistoryInChunks) {
+  // Add enough visits to the profile for history to be sent in two chunks.
+  {
+    sql::Database db;
+    ASSERT_TRUE(db.Open(profile_dir_.AppendASCII("History")));
+    for (int i = 0; i < 1500; ++i) {
+      sql::Statement url_statement(db.GetUniqueStatement(
+          "INSERT INTO urls (url, title, last_visit_time) VALUES (?, ?, ?)"));
+      url_statement.BindString(
+          0, "https://example.com/" + std::to_string(i));
+      url_statement.BindString(1, "Example");
+      url_statement.BindInt64(2, 13228000000000000);
+      ASSERT_TRUE(url_statement.Run());
+
+      sql::Statement visit_statement(db.GetUniqueStatement(
+          "INSERT INTO visits (url, visit_time, transition) "
+          "VALUES (?, ?, ?)"));
+      visit_statement.BindInt64(0, db.GetLastInsertRowId());
+      visit_statement.BindInt64(1, 13228000000000000);
+      visit_statement.BindInt64(2, ui::PAGE_TRANSITION_LINK |
+                                       ui::PAGE_TRANSITION_CHAIN_START |
+                                       ui::PAGE_TRANSITION_CHAIN_END);
+      ASSERT_TRUE(visit_statement.Run());
+    }
+  }
+
+  std::vector<ImporterURLRow> first_chunk;
+  std::vector<ImporterURLRow> second_chunk;
+
+  EXPECT_CALL(*bridge_, NotifyStarted());
+  EXPECT_CALL(*bridge_, NotifyItemStarted(importer::HISTORY));
+  EXPECT_CALL(*bridge_, SetHistoryItems(_, _))
+      .WillOnce(::testing::SaveArg<0>(&first_chunk))
+      .WillOnce(::testing::SaveArg<0>(&second_chunk));
+  EXPECT_CALL(*bridge_, NotifyItemEnded(importer::HISTORY));
+  EXPECT_CALL(*bridge_, NotifyEnded());
+
+  importer_->StartImport(profile_, importer::HISTORY, bridge_.get());
+
+  // The 3 visits of the test profile and the 1500 added ones.
+  ASSERT_EQ(1000u, first_chunk.size());
+  ASSERT_EQ(503u, second_chunk.size());
+  EXPECT_EQ("https://brave.com/", first_chunk[0].url.spec());
+}
+
 TEST_F(ChromeImporterTest, ImportBookmarks) {
   std::vector<ImportedBookmarkEntry> bookmarks;
 